@@ -0,0 +1,294 @@
+/*
+================================================================================
+  ash/atomic_static_string.h - A `basic_static_string` that can be published and read
+  concurrently without locks.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::basic_atomic_static_string<CharT, N>` is a seqlock around the size
+    and the characters of a string:
+
+    - A writer makes the sequence number odd, writes the new value and makes
+      it even again.
+    - A reader reads the sequence number, copies the value and reads the
+      sequence number again. If it was odd or has changed in between, the
+      copy may be torn and the reader tries again.
+
+    Readers never write to shared memory, so many threads can read the same
+    value without bouncing its cache line between cores (unlike a
+    `std::shared_mutex`, where every reader writes the lock). Writers are
+    serialized with a CAS on the sequence number.
+
+    Readers only retry while a write is in progress, so this fits values
+    which are read very often and written rarely (configuration, the name of
+    the current leader, etc.).
+
+  Usage:
+    #include "ash/atomic_static_string.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_ATOMIC_STATIC_STRING
+
+================================================================================
+*/
+
+#ifndef ASH_ATOMIC_STATIC_STRING
+#define ASH_ATOMIC_STATIC_STRING
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include "../ash/static_string.h"
+
+namespace ash {
+    /// @class basic_atomic_static_string
+    /// @brief A `basic_static_string<CharT, N>` with atomic `load` and `store` (seqlock).
+    /// @tparam CharT Character type.
+    /// @tparam N Capacity.
+    template <class CharT, std::size_t N>
+    class basic_atomic_static_string;
+
+    template <std::size_t N>
+    using atomic_static_string = basic_atomic_static_string<char, N>;
+}
+
+template <class CharT, std::size_t N>
+class alignas(64) ash::basic_atomic_static_string {
+public:
+    using value_type = basic_static_string<CharT, N>;
+    using size_type = std::size_t;
+
+private:
+    /// @brief The size is in the first word and the characters follow it.
+    static constexpr size_type words = (sizeof(std::uint64_t) + N * sizeof(CharT) + 7) / 8;
+
+public:
+
+// Constructors
+
+    /// @brief Constructs an empty string.
+    basic_atomic_static_string() noexcept;
+
+    /// @brief Constructs with `value`.
+    basic_atomic_static_string(const value_type& value) noexcept;
+
+    basic_atomic_static_string(const basic_atomic_static_string&) = delete;
+    basic_atomic_static_string& operator=(const basic_atomic_static_string&) = delete;
+
+// Operations
+
+    /// @brief A consistent copy of the current value. Lock-free; spins only while a `store` is
+    /// in progress.
+    value_type load() const noexcept;
+
+    /// @brief Publishes `value`. Concurrent stores are serialized.
+    void store(const value_type& value) noexcept;
+
+    /// @brief Publishes `value` and returns the previous value.
+    value_type exchange(const value_type& value) noexcept;
+
+    /// @brief Publishes `desired` if the current value is equal to `expected`. Otherwise, loads the
+    /// current value into `expected`.
+    /// @return `true` if `desired` was published.
+    bool compare_exchange(value_type& expected, const value_type& desired) noexcept;
+
+    /// @brief The number of completed stores. Can be polled to detect a change cheaply.
+    std::uint64_t version() const noexcept;
+
+// Conversions
+
+    /// @brief Equivalent to `load()`.
+    operator value_type() const noexcept;
+
+    /// @brief Equivalent to `store(value)`.
+    basic_atomic_static_string& operator=(const value_type& value) noexcept;
+
+private:
+    /// @brief Makes the sequence number odd. Returns the odd value.
+    std::uint64_t lock() noexcept;
+
+    /// @brief Makes the sequence number even again.
+    void unlock(std::uint64_t locked) noexcept;
+
+    /// @brief Copies the words of `value` (only as many as its size needs) into the shared
+    /// words. Must be called between `lock` and `unlock`.
+    void write(const value_type& value) noexcept;
+
+    /// @brief Copies the shared words into `out`. The result may be torn.
+    /// @return The size read from the first word, clamped to `N`.
+    size_type read(std::uint64_t (&out)[words]) const noexcept;
+
+    static value_type make(const std::uint64_t (&snapshot)[words], size_type size) noexcept;
+
+    // The sequence number and (the beginning of) the value share the first cache line, so a
+    // reader of a short string touches only one line.
+    std::atomic<std::uint64_t> sequence { 0 };
+    std::atomic<std::uint64_t> data[words];
+};
+
+#define ASH_bass_template template <class CharT, std::size_t N>
+#define ASH_bass_name ash::basic_atomic_static_string<CharT, N>
+
+ASH_bass_template
+ASH_bass_name::basic_atomic_static_string() noexcept {
+    for (auto& word : data)
+        word.store(0, std::memory_order_relaxed);
+}
+
+ASH_bass_template
+ASH_bass_name::basic_atomic_static_string(const value_type& value) noexcept : basic_atomic_static_string() {
+    write(value);
+}
+
+ASH_bass_template
+typename ASH_bass_name::value_type ASH_bass_name::load() const noexcept {
+    std::uint64_t snapshot[words];
+
+    for (;;) {
+        std::uint64_t before = sequence.load(std::memory_order_acquire);
+
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        size_type size = read(snapshot);
+
+        // Orders the (relaxed) reads of the data before the second read of the sequence number.
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (sequence.load(std::memory_order_relaxed) == before)
+            return make(snapshot, size);
+    }
+}
+
+ASH_bass_template
+void ASH_bass_name::store(const value_type& value) noexcept {
+    std::uint64_t locked = lock();
+    write(value);
+    unlock(locked);
+}
+
+ASH_bass_template
+typename ASH_bass_name::value_type ASH_bass_name::exchange(const value_type& value) noexcept {
+    std::uint64_t locked = lock();
+
+    // No other writer can run, so the data can't be torn.
+    std::uint64_t snapshot[words];
+    size_type size = read(snapshot);
+
+    write(value);
+    unlock(locked);
+
+    return make(snapshot, size);
+}
+
+ASH_bass_template
+bool ASH_bass_name::compare_exchange(value_type& expected, const value_type& desired) noexcept {
+    std::uint64_t locked = lock();
+
+    std::uint64_t snapshot[words];
+    size_type size = read(snapshot);
+    value_type current = make(snapshot, size);
+
+    bool equal = (current == expected);
+    if (equal)
+        write(desired);
+    else
+        expected = current;
+
+    unlock(locked);
+    return equal;
+}
+
+ASH_bass_template
+std::uint64_t ASH_bass_name::version() const noexcept {
+    return sequence.load(std::memory_order_acquire) / 2;
+}
+
+ASH_bass_template
+ASH_bass_name::operator value_type() const noexcept {
+    return load();
+}
+
+ASH_bass_template
+ASH_bass_name& ASH_bass_name::operator=(const value_type& value) noexcept {
+    store(value);
+    return *this;
+}
+
+ASH_bass_template
+std::uint64_t ASH_bass_name::lock() noexcept {
+    std::uint64_t current = sequence.load(std::memory_order_relaxed);
+
+    for (;;) {
+        if (current & 1) {
+            std::this_thread::yield();
+            current = sequence.load(std::memory_order_relaxed);
+        }
+        else if (sequence.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // Orders the odd sequence number before the (relaxed) writes of the data.
+    std::atomic_thread_fence(std::memory_order_release);
+    return current + 1;
+}
+
+ASH_bass_template
+void ASH_bass_name::unlock(std::uint64_t locked) noexcept {
+    sequence.store(locked + 1, std::memory_order_release);
+}
+
+ASH_bass_template
+void ASH_bass_name::write(const value_type& value) noexcept {
+    unsigned char bytes[words * 8];
+
+    std::uint64_t size = value.size();
+    std::memcpy(bytes, &size, sizeof(size));
+    std::memcpy(bytes + sizeof(size), value.data(), value.size() * sizeof(CharT));
+
+    size_type used = (sizeof(size) + value.size() * sizeof(CharT) + 7) / 8;
+    for (size_type i = 0; i < used; ++i) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i * 8, 8);
+        data[i].store(word, std::memory_order_relaxed);
+    }
+}
+
+ASH_bass_template
+typename ASH_bass_name::size_type ASH_bass_name::read(std::uint64_t (&out)[words]) const noexcept {
+    out[0] = data[0].load(std::memory_order_relaxed);
+
+    // A torn read can see any size. It is thrown away later, but must not overflow `out`.
+    size_type size = (out[0] < N) ? static_cast<size_type>(out[0]) : N;
+
+    size_type used = (sizeof(std::uint64_t) + size * sizeof(CharT) + 7) / 8;
+    for (size_type i = 1; i < used; ++i)
+        out[i] = data[i].load(std::memory_order_relaxed);
+
+    return size;
+}
+
+ASH_bass_template
+typename ASH_bass_name::value_type ASH_bass_name::make(const std::uint64_t (&snapshot)[words], size_type size) noexcept {
+    value_type result;
+    result.resize_and_overwrite(size, [&snapshot, size](CharT* out, size_type) {
+        std::memcpy(out, reinterpret_cast<const unsigned char*>(snapshot) + sizeof(std::uint64_t), size * sizeof(CharT));
+        return size;
+    });
+
+    return result;
+}
+
+#undef ASH_bass_template
+#undef ASH_bass_name
+
+#endif // ASH_ATOMIC_STATIC_STRING
@@ -0,0 +1,400 @@
+/*
+================================================================================
+  ash/base64.h - Base64 encoding and decoding into `ash::static_string`s.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    - `ash::base64_encode(bytes)` returns a `static_string` whose capacity is
+      the encoded size of `N` input bytes.
+    - `ash::base64_decode(str)` returns a `static_string<N * 3 / 4>` of the
+      bytes. Invalid input throws `std::invalid_argument`.
+
+    Both alphabets of RFC 4648 are supported: `standard` (`+/`, padded with
+    '=') and `url` (`-_`, without padding). The decoder accepts input with or
+    without padding, and rejects non-zero bits after the last byte.
+
+    Both are constexpr. At runtime, with SSSE3, 12 bytes are encoded to 16
+    characters (and back) at a time, after Muła and Lemire: the 6-bit
+    indices are gathered with a shuffle and two multiplies, and are mapped
+    to characters (and back) with `pshufb` table lookups, which also
+    validate the input.
+
+  Usage:
+    #include "ash/base64.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_BASE64
+
+================================================================================
+*/
+
+#ifndef ASH_BASE64
+#define ASH_BASE64
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include "../ash/simd.h"
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @brief The alphabets of RFC 4648.
+    enum class base64_alphabet {
+        /// @brief `A-Z a-z 0-9 + /`, padded with '='.
+        standard,
+
+        /// @brief `A-Z a-z 0-9 - _`, without padding.
+        url
+    };
+
+    /// @brief The number of characters `size` bytes are encoded to.
+    constexpr std::size_t base64_encoded_size(std::size_t size, base64_alphabet alphabet = base64_alphabet::standard) noexcept;
+
+    /// @brief Writes the encoding of [`in`, `in + size`) to `out`.
+    /// @tparam Byte A type of 1 byte (`char`, `unsigned char`, `std::byte`, ...).
+    /// @return The number of characters written, `base64_encoded_size(size, alphabet)`.
+    template <class Byte>
+    constexpr std::size_t base64_encode(const Byte* in, std::size_t size, char* out, base64_alphabet alphabet = base64_alphabet::standard) noexcept;
+
+    /// @brief Writes the bytes of [`in`, `in + size`) to `out`, which needs room for `size * 3 / 4`
+    /// bytes.
+    /// @return The number of bytes written, or `std::size_t(-1)` if the input is invalid.
+    template <class Byte>
+    constexpr std::size_t base64_decode(const char* in, std::size_t size, Byte* out, base64_alphabet alphabet = base64_alphabet::standard) noexcept;
+
+    template <base64_alphabet Alphabet = base64_alphabet::standard, class CharT, std::size_t N>
+    constexpr auto base64_encode(const basic_static_string<CharT, N>& bytes) noexcept -> static_string<base64_encoded_size(N, Alphabet)>;
+
+    template <base64_alphabet Alphabet = base64_alphabet::standard, class T, std::size_t N>
+    constexpr auto base64_encode(const std::array<T, N>& bytes) noexcept -> static_string<base64_encoded_size(N, Alphabet)>;
+
+    /// @exception `std::invalid_argument` if `str` is not valid base64.
+    template <base64_alphabet Alphabet = base64_alphabet::standard, std::size_t N>
+    constexpr static_string<N * 3 / 4> base64_decode(const static_string<N>& str);
+
+    /// @brief Decodes `str` into a string of capacity `N`.
+    /// @exception `std::invalid_argument` if `str` is not valid base64.
+    /// @exception `std::out_of_range` if the result is longer than `N`.
+    template <std::size_t N, base64_alphabet Alphabet = base64_alphabet::standard>
+    constexpr static_string<N> base64_decode(std::string_view str);
+
+    namespace __base64_details {
+        constexpr const char* characters(base64_alphabet alphabet) noexcept {
+            return alphabet == base64_alphabet::url
+                ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+                : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        }
+
+        /// @brief The 6-bit value of a character, or `-1`.
+        constexpr int value(char c, base64_alphabet alphabet) noexcept {
+            if (c >= 'A' && c <= 'Z')
+                return c - 'A';
+            if (c >= 'a' && c <= 'z')
+                return c - 'a' + 26;
+            if (c >= '0' && c <= '9')
+                return c - '0' + 52;
+            if (c == (alphabet == base64_alphabet::url ? '-' : '+'))
+                return 62;
+            if (c == (alphabet == base64_alphabet::url ? '_' : '/'))
+                return 63;
+
+            return -1;
+        }
+
+        /// @brief The values of all 256 characters of an alphabet (`-1` for invalid ones).
+        struct decode_table {
+            signed char values[256] {};
+        };
+
+        constexpr decode_table make_decode_table(base64_alphabet alphabet) noexcept {
+            decode_table table;
+            for (int c = 0; c < 256; ++c)
+                table.values[c] = static_cast<signed char>(value(static_cast<char>(c), alphabet));
+
+            return table;
+        }
+
+        template <base64_alphabet Alphabet>
+        inline constexpr decode_table decode_tables = make_decode_table(Alphabet);
+
+        /// @brief Encodes blocks of 12 bytes and returns how many bytes were encoded.
+        std::size_t encode_simd(const unsigned char* in, std::size_t size, char* out, base64_alphabet alphabet) noexcept;
+
+        /// @brief Decodes blocks of 16 characters and returns how many characters were decoded.
+        /// Stops before the first block with an invalid character.
+        std::size_t decode_simd(const char* in, std::size_t size, unsigned char* out, base64_alphabet alphabet) noexcept;
+    }
+}
+
+#ifdef ASH_SIMD_SSSE3
+
+inline std::size_t ash::__base64_details::encode_simd(const unsigned char* in, std::size_t size, char* out, base64_alphabet alphabet) noexcept {
+    bool url = (alphabet == base64_alphabet::url);
+
+    // Maps the class of every index (0: a-z, 1...10: 0-9, 11: 62, 12: 63, 13: A-Z) to what has to be
+    // added to it.
+    const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        static_cast<char>((url ? '-' : '+') - 62), static_cast<char>((url ? '_' : '/') - 63),
+                                        'A', 0, 0);
+
+    std::size_t i = 0;
+
+    // Loads 16 bytes and uses 12.
+    for (; i + 16 <= size; i += 12) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+        // Every 32-bit lane gets the bytes [b1, b0, b2, b1] of a 3-byte group.
+        v = _mm_shuffle_epi8(v, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+        // Moves the four 6-bit fields of every lane into their own byte.
+        __m128i ac = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        __m128i bd = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(ac, bd);
+
+        // 0...25 are class 13 (which shifts by 'A'), 26...51 class 0, and 52...63 classes 1...12.
+        __m128i classes = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        classes = _mm_or_si128(classes, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+
+        __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(shift, classes), indices);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 3 * 4), chars);
+    }
+
+    return i;
+}
+
+inline std::size_t ash::__base64_details::decode_simd(const char* in, std::size_t size, unsigned char* out, base64_alphabet alphabet) noexcept {
+    // Valid characters have no bit in common between their low-nibble and high-nibble classes.
+    const __m128i lut_low = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                          0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_high = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                           0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+
+    // What has to be added to a character, by its high nibble ('/' has its own entry).
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+
+    bool url = (alphabet == base64_alphabet::url);
+
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+        if (url) {
+            // The tables are for the standard alphabet, so "-_" become "+/" (which are invalid here).
+            __m128i standard = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('+')), _mm_cmpeq_epi8(v, _mm_set1_epi8('/')));
+            if (_mm_movemask_epi8(standard) != 0)
+                break;
+
+            __m128i dash = _mm_cmpeq_epi8(v, _mm_set1_epi8('-'));
+            __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+            v = _mm_or_si128(_mm_andnot_si128(_mm_or_si128(dash, underscore), v),
+                             _mm_or_si128(_mm_and_si128(dash, _mm_set1_epi8('+')), _mm_and_si128(underscore, _mm_set1_epi8('/'))));
+        }
+
+        __m128i high_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), low_mask);
+        __m128i low = _mm_shuffle_epi8(lut_low, _mm_and_si128(v, low_mask));
+        __m128i high = _mm_shuffle_epi8(lut_high, high_nibbles);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128())) != 0xFFFF)
+            break;
+
+        __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+        __m128i values = _mm_add_epi8(v, _mm_shuffle_epi8(lut_roll, _mm_add_epi8(slash, high_nibbles)));
+
+        // Joins 4 values of 6 bits into 3 bytes in every 32-bit lane, then packs the lanes.
+        __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i lanes = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        __m128i bytes = _mm_shuffle_epi8(lanes, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        // Only 12 bytes are written, so `out` needs no slack.
+        unsigned char* target = out + i / 4 * 3;
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(target), bytes);
+        int last = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+        std::memcpy(target + 8, &last, 4);
+    }
+
+    return i;
+}
+
+#endif // ASH_SIMD_SSSE3
+
+constexpr std::size_t ash::base64_encoded_size(std::size_t size, base64_alphabet alphabet) noexcept {
+    return alphabet == base64_alphabet::url ? (size * 4 + 2) / 3 : (size + 2) / 3 * 4;
+}
+
+template <class Byte>
+constexpr std::size_t ash::base64_encode(const Byte* in, std::size_t size, char* out, base64_alphabet alphabet) noexcept {
+    static_assert(sizeof(Byte) == 1, "ash::base64_encode: The input must be bytes.");
+
+    std::size_t i = 0;
+
+#ifdef ASH_SIMD_SSSE3
+    if (!__builtin_is_constant_evaluated())
+        i = __base64_details::encode_simd(reinterpret_cast<const unsigned char*>(in), size, out, alphabet);
+#endif
+
+    const char* chars = __base64_details::characters(alphabet);
+    char* o = out + i / 3 * 4;
+
+    for (; i + 3 <= size; i += 3) {
+        std::uint32_t group = (std::uint32_t(static_cast<unsigned char>(in[i])) << 16)
+                            | (std::uint32_t(static_cast<unsigned char>(in[i + 1])) << 8)
+                            | std::uint32_t(static_cast<unsigned char>(in[i + 2]));
+
+        *o++ = chars[group >> 18];
+        *o++ = chars[(group >> 12) & 0x3F];
+        *o++ = chars[(group >> 6) & 0x3F];
+        *o++ = chars[group & 0x3F];
+    }
+
+    std::size_t left = size - i;
+    if (left != 0) {
+        std::uint32_t group = std::uint32_t(static_cast<unsigned char>(in[i])) << 16;
+        if (left == 2)
+            group |= std::uint32_t(static_cast<unsigned char>(in[i + 1])) << 8;
+
+        *o++ = chars[group >> 18];
+        *o++ = chars[(group >> 12) & 0x3F];
+        if (left == 2)
+            *o++ = chars[(group >> 6) & 0x3F];
+
+        if (alphabet == base64_alphabet::standard) {
+            *o++ = '=';
+            if (left == 1)
+                *o++ = '=';
+        }
+    }
+
+    return static_cast<std::size_t>(o - out);
+}
+
+template <class Byte>
+constexpr std::size_t ash::base64_decode(const char* in, std::size_t size, Byte* out, base64_alphabet alphabet) noexcept {
+    static_assert(sizeof(Byte) == 1, "ash::base64_decode: The output must be bytes.");
+
+    constexpr std::size_t invalid = std::size_t(-1);
+
+    // Padding only makes the size a multiple of 4.
+    if (size % 4 == 0 && size != 0 && in[size - 1] == '=') {
+        --size;
+        if (in[size - 1] == '=')
+            --size;
+    }
+
+    if (size % 4 == 1)
+        return invalid;
+
+    std::size_t i = 0;
+
+#ifdef ASH_SIMD_SSSE3
+    if (!__builtin_is_constant_evaluated())
+        i = __base64_details::decode_simd(in, size, reinterpret_cast<unsigned char*>(out), alphabet);
+#endif
+
+    Byte* o = out + i / 4 * 3;
+
+    const signed char* values = (alphabet == base64_alphabet::url)
+        ? __base64_details::decode_tables<base64_alphabet::url>.values
+        : __base64_details::decode_tables<base64_alphabet::standard>.values;
+
+    std::uint32_t group = 0;
+    std::size_t count = 0;
+
+    for (; i < size; ++i) {
+        int v = values[static_cast<unsigned char>(in[i])];
+        if (v < 0)
+            return invalid;
+
+        group = (group << 6) | static_cast<std::uint32_t>(v);
+
+        if (++count == 4) {
+            *o++ = static_cast<Byte>(group >> 16);
+            *o++ = static_cast<Byte>(group >> 8);
+            *o++ = static_cast<Byte>(group);
+            group = 0;
+            count = 0;
+        }
+    }
+
+    // 2 or 3 characters left, for 1 or 2 bytes. The bits after them must be zero.
+    if (count == 2) {
+        if (group & 0x0F)
+            return invalid;
+
+        *o++ = static_cast<Byte>(group >> 4);
+    }
+    else if (count == 3) {
+        if (group & 0x03)
+            return invalid;
+
+        *o++ = static_cast<Byte>(group >> 10);
+        *o++ = static_cast<Byte>(group >> 2);
+    }
+
+    return static_cast<std::size_t>(o - out);
+}
+
+template <ash::base64_alphabet Alphabet, class CharT, std::size_t N>
+constexpr auto ash::base64_encode(const basic_static_string<CharT, N>& bytes) noexcept -> static_string<base64_encoded_size(N, Alphabet)> {
+    static_string<base64_encoded_size(N, Alphabet)> result;
+    result.resize_and_overwrite(base64_encoded_size(bytes.size(), Alphabet), [&bytes](char* out, std::size_t) {
+        return ash::base64_encode(bytes.data(), bytes.size(), out, Alphabet);
+    });
+
+    return result;
+}
+
+template <ash::base64_alphabet Alphabet, class T, std::size_t N>
+constexpr auto ash::base64_encode(const std::array<T, N>& bytes) noexcept -> static_string<base64_encoded_size(N, Alphabet)> {
+    static_string<base64_encoded_size(N, Alphabet)> result;
+    result.resize_and_overwrite(base64_encoded_size(N, Alphabet), [&bytes](char* out, std::size_t) {
+        return ash::base64_encode(bytes.data(), N, out, Alphabet);
+    });
+
+    return result;
+}
+
+template <ash::base64_alphabet Alphabet, std::size_t N>
+constexpr ash::static_string<N * 3 / 4> ash::base64_decode(const static_string<N>& str) {
+    return ash::base64_decode<N * 3 / 4, Alphabet>(std::string_view(str.data(), str.size()));
+}
+
+template <std::size_t N, ash::base64_alphabet Alphabet>
+constexpr ash::static_string<N> ash::base64_decode(std::string_view str) {
+    // An upper bound, the padding and the last group may decode to fewer bytes.
+    std::size_t bound = (str.size() + 3) / 4 * 3;
+
+    if (bound > N) {
+        std::size_t unpadded = str.size();
+        while (unpadded != 0 && str[unpadded - 1] == '=')
+            --unpadded;
+
+        ash::throw_if_outside_of_capacity(N, unpadded * 3 / 4);
+        bound = N;
+    }
+
+    static_string<N> result;
+
+    std::size_t written = 0;
+    result.resize_and_overwrite(bound, [&str, &written](char* out, std::size_t) {
+        written = ash::base64_decode(str.data(), str.size(), out, Alphabet);
+        return written == std::size_t(-1) ? 0 : written;
+    });
+
+    if (written == std::size_t(-1))
+        throw std::invalid_argument("ash::base64_decode: The input is not valid base64.");
+
+    return result;
+}
+
+#endif // ASH_BASE64
@@ -0,0 +1,313 @@
+/*
+================================================================================
+  ash/char_class.h - Character classes and the kernels that classify whole
+  strings with them.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::char_class` is a set of bytes: one of the predefined classes in
+    `ash::char_classes` (digit, lower, upper, alpha, alnum, hex, identifier,
+    whitespace), or one made from a 256-entry table, a predicate, a list of
+    characters or a range. Classes combine with `|`, `&` and `~`.
+
+    - `ash::all_of_class(str, cls)`
+    - `ash::count_class(str, cls)`
+    - `ash::find_first_in_class(str, cls)`
+    - `ash::find_first_not_in_class(str, cls)`
+    - `ash::find_last_not_in_class(str, cls)`
+
+    Everything is constexpr. At runtime with SSSE3, 16 characters are
+    classified at a time with three `pshufb` lookups: the class is stored as
+    two 16-byte tables indexed by the low nibble, whose bits are the high
+    nibbles (0-7 in one table, 8-15 in the other) that are in the class. This
+    works for any set of bytes, not only ranges. Without SSSE3, each character
+    is one lookup in a 256-byte table, and the loops only branch once per 16
+    characters.
+
+  Usage:
+    #include "ash/char_class.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_CHAR_CLASS
+
+================================================================================
+*/
+
+#ifndef ASH_CHAR_CLASS
+#define ASH_CHAR_CLASS
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "../ash/simd.h"
+
+namespace ash {
+    /// @class char_class
+    /// @brief A set of bytes.
+    class char_class;
+
+    /// @brief Checks if every character of `str` is in `cls` (`true` for an empty string).
+    constexpr bool all_of_class(std::string_view str, const char_class& cls) noexcept;
+
+    /// @brief The number of characters of `str` in `cls`.
+    constexpr std::size_t count_class(std::string_view str, const char_class& cls) noexcept;
+
+    /// @brief The position of the first character of `str` in `cls`, or `std::string_view::npos`.
+    constexpr std::size_t find_first_in_class(std::string_view str, const char_class& cls) noexcept;
+
+    /// @brief The position of the first character of `str` not in `cls`, or `std::string_view::npos`.
+    constexpr std::size_t find_first_not_in_class(std::string_view str, const char_class& cls) noexcept;
+
+    /// @brief The position of the last character of `str` not in `cls`, or `std::string_view::npos`.
+    constexpr std::size_t find_last_not_in_class(std::string_view str, const char_class& cls) noexcept;
+
+    namespace __char_class_details {
+        /// @brief Bit `i` is set if `p[i]` is in the class, for the 16 characters at `p`.
+        unsigned match16(const char* p, const char_class& cls) noexcept;
+    }
+}
+
+class ash::char_class {
+public:
+// Constructors
+
+    /// @brief The empty class.
+    constexpr char_class() noexcept = default;
+
+    /// @brief The class of the bytes `c` for which `table[c]` is `true`.
+    constexpr explicit char_class(const std::array<bool, 256>& table) noexcept;
+
+    /// @brief The class of the bytes `c` for which `pred(char(c))` is `true`.
+    template <class Predicate>
+    static constexpr char_class matching(Predicate pred);
+
+    /// @brief The class of the characters of `chars`.
+    static constexpr char_class of(std::string_view chars) noexcept;
+
+    /// @brief The class of [`first`, `last`] (as unsigned bytes).
+    static constexpr char_class range(char first, char last) noexcept;
+
+// Operations
+
+    constexpr bool contains(char c) const noexcept;
+
+    constexpr char_class& insert(char c) noexcept;
+
+    constexpr char_class operator|(const char_class& other) const noexcept;
+    constexpr char_class operator&(const char_class& other) const noexcept;
+    constexpr char_class operator~() const noexcept;
+
+    /// @brief The lookup tables of the `pshufb` kernel. Byte `lo` of the first 16 has bit `hi` set if
+    /// `hi * 16 + lo` is in the class (for `hi < 8`), and the last 16 the same for `(hi + 8) * 16 + lo`.
+    constexpr const std::array<unsigned char, 32>& tables() const noexcept { return rows; }
+
+private:
+    std::array<unsigned char, 32> rows{};
+
+    // The same set, one byte per character, for the scalar lookups.
+    std::array<bool, 256> members{};
+};
+
+constexpr ash::char_class::char_class(const std::array<bool, 256>& table) noexcept {
+    for (std::size_t c = 0; c < 256; ++c)
+        if (table[c])
+            insert(static_cast<char>(c));
+}
+
+template <class Predicate>
+constexpr ash::char_class ash::char_class::matching(Predicate pred) {
+    char_class result;
+    for (std::size_t c = 0; c < 256; ++c)
+        if (pred(static_cast<char>(c)))
+            result.insert(static_cast<char>(c));
+
+    return result;
+}
+
+constexpr ash::char_class ash::char_class::of(std::string_view chars) noexcept {
+    char_class result;
+    for (char c : chars)
+        result.insert(c);
+
+    return result;
+}
+
+constexpr ash::char_class ash::char_class::range(char first, char last) noexcept {
+    char_class result;
+    for (unsigned c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); ++c)
+        result.insert(static_cast<char>(c));
+
+    return result;
+}
+
+constexpr bool ash::char_class::contains(char c) const noexcept {
+    return members[static_cast<unsigned char>(c)];
+}
+
+constexpr ash::char_class& ash::char_class::insert(char c) noexcept {
+    auto u = static_cast<unsigned char>(c);
+    rows[(u >> 7) * 16 + (u & 0x0F)] |= static_cast<unsigned char>(1 << ((u >> 4) & 7));
+    members[u] = true;
+    return *this;
+}
+
+constexpr ash::char_class ash::char_class::operator|(const char_class& other) const noexcept {
+    char_class result;
+    for (std::size_t i = 0; i < 32; ++i)
+        result.rows[i] = static_cast<unsigned char>(rows[i] | other.rows[i]);
+
+    for (std::size_t i = 0; i < 256; ++i)
+        result.members[i] = members[i] || other.members[i];
+
+    return result;
+}
+
+constexpr ash::char_class ash::char_class::operator&(const char_class& other) const noexcept {
+    char_class result;
+    for (std::size_t i = 0; i < 32; ++i)
+        result.rows[i] = static_cast<unsigned char>(rows[i] & other.rows[i]);
+
+    for (std::size_t i = 0; i < 256; ++i)
+        result.members[i] = members[i] && other.members[i];
+
+    return result;
+}
+
+constexpr ash::char_class ash::char_class::operator~() const noexcept {
+    char_class result;
+    for (std::size_t i = 0; i < 32; ++i)
+        result.rows[i] = static_cast<unsigned char>(~rows[i]);
+
+    for (std::size_t i = 0; i < 256; ++i)
+        result.members[i] = !members[i];
+
+    return result;
+}
+
+namespace ash {
+    /// @brief The predefined classes (ASCII only).
+    namespace char_classes {
+        inline constexpr char_class digit = char_class::range('0', '9');
+        inline constexpr char_class lower = char_class::range('a', 'z');
+        inline constexpr char_class upper = char_class::range('A', 'Z');
+        inline constexpr char_class alpha = lower | upper;
+        inline constexpr char_class alnum = alpha | digit;
+        inline constexpr char_class hex = digit | char_class::range('a', 'f') | char_class::range('A', 'F');
+        inline constexpr char_class identifier = alnum | char_class::of("_");
+        inline constexpr char_class whitespace = char_class::of(" \t\n\v\f\r");
+    }
+}
+
+#ifdef ASH_SIMD_SSSE3
+
+inline unsigned ash::__char_class_details::match16(const char* p, const char_class& cls) noexcept {
+    const __m128i low_rows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cls.tables().data()));
+    const __m128i high_rows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cls.tables().data() + 16));
+    const __m128i bit_of_row = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+    // Keeping bit 7 in the index makes `pshufb` return 0, so each table only answers for its half.
+    __m128i index = _mm_and_si128(v, _mm_set1_epi8(static_cast<char>(0x8F)));
+    __m128i row = _mm_or_si128(_mm_shuffle_epi8(low_rows, index),
+                               _mm_shuffle_epi8(high_rows, _mm_xor_si128(index, _mm_set1_epi8(static_cast<char>(0x80)))));
+
+    __m128i bit = _mm_shuffle_epi8(bit_of_row, _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F)));
+
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit)));
+}
+
+#else
+
+inline unsigned ash::__char_class_details::match16(const char* p, const char_class& cls) noexcept {
+    // No branch per character, so the loops only branch once per 16 characters.
+    unsigned mask = 0;
+    for (unsigned i = 0; i < 16; ++i)
+        mask |= static_cast<unsigned>(cls.contains(p[i])) << i;
+
+    return mask;
+}
+
+#endif // ASH_SIMD_SSSE3
+
+constexpr bool ash::all_of_class(std::string_view str, const char_class& cls) noexcept {
+    return ash::find_first_not_in_class(str, cls) == std::string_view::npos;
+}
+
+constexpr std::size_t ash::count_class(std::string_view str, const char_class& cls) noexcept {
+    std::size_t i = 0;
+    std::size_t count = 0;
+
+    if (!__builtin_is_constant_evaluated())
+        for (; i + 16 <= str.size(); i += 16)
+            count += ash::simd::popcount(__char_class_details::match16(str.data() + i, cls));
+
+    for (; i < str.size(); ++i)
+        count += cls.contains(str[i]);
+
+    return count;
+}
+
+constexpr std::size_t ash::find_first_in_class(std::string_view str, const char_class& cls) noexcept {
+    std::size_t i = 0;
+
+    if (!__builtin_is_constant_evaluated()) {
+        for (; i + 16 <= str.size(); i += 16) {
+            unsigned mask = __char_class_details::match16(str.data() + i, cls);
+            if (mask != 0)
+                return i + ash::simd::ctz(mask);
+        }
+    }
+
+    for (; i < str.size(); ++i)
+        if (cls.contains(str[i]))
+            return i;
+
+    return std::string_view::npos;
+}
+
+constexpr std::size_t ash::find_first_not_in_class(std::string_view str, const char_class& cls) noexcept {
+    std::size_t i = 0;
+
+    if (!__builtin_is_constant_evaluated()) {
+        for (; i + 16 <= str.size(); i += 16) {
+            unsigned mask = ~__char_class_details::match16(str.data() + i, cls) & 0xFFFF;
+            if (mask != 0)
+                return i + ash::simd::ctz(mask);
+        }
+    }
+
+    for (; i < str.size(); ++i)
+        if (!cls.contains(str[i]))
+            return i;
+
+    return std::string_view::npos;
+}
+
+constexpr std::size_t ash::find_last_not_in_class(std::string_view str, const char_class& cls) noexcept {
+    std::size_t i = str.size();
+
+    if (!__builtin_is_constant_evaluated()) {
+        for (; i >= 16; i -= 16) {
+            unsigned mask = ~__char_class_details::match16(str.data() + i - 16, cls) & 0xFFFF;
+            if (mask != 0)
+                return i - 16 + (31 - static_cast<unsigned>(__builtin_clz(mask)));
+        }
+    }
+
+    while (i > 0) {
+        --i;
+        if (!cls.contains(str[i]))
+            return i;
+    }
+
+    return std::string_view::npos;
+}
+
+#endif // ASH_CHAR_CLASS
@@ -0,0 +1,342 @@
+/*
+================================================================================
+  ash/csv.h - SIMD splitting of delimited text into `ash::static_string` fields.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    - `ash::split` splits a string at a delimiter (no quoting).
+    - `ash::csv_reader` reads CSV / TSV records (RFC 4180 quoting: a quoted
+      field may contain delimiters, newlines and doubled quotes).
+
+    Both write the fields into a caller `std::array<static_string<N>, K>` or
+    into `std::string_view`s over the input. Nothing is allocated.
+
+    The input is scanned 64 bytes at a time, like simdcsv: the delimiters,
+    the newlines and the quotes of a block become three 64-bit masks. The
+    prefix XOR of the quote mask is the mask of the bytes inside quotes
+    (carried over from block to block), and the delimiters and newlines
+    outside of it are the field boundaries. Every field is then found with a
+    count of trailing zeros instead of a loop over its characters.
+
+    A trailing '\r' before the newline (CRLF) is dropped.
+
+  Usage:
+    #include "ash/csv.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_CSV
+
+================================================================================
+*/
+
+#ifndef ASH_CSV
+#define ASH_CSV
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "../ash/simd.h"
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @brief The separators of `csv_reader`.
+    struct csv_dialect {
+        char delimiter = ',';
+
+        /// @brief `'\0'` disables quoting, e.g. for TSV.
+        char quote = '"';
+
+        /// @brief Tab separated, without quoting.
+        static constexpr csv_dialect tsv() noexcept { return { '\t', '\0' }; }
+    };
+
+    /// @class csv_reader
+    /// @brief Reads the records of a CSV / TSV text one by one.
+    class csv_reader;
+
+    /// @brief Splits `input` at every `delimiter`.
+    /// @param fields Receives the first `capacity` fields, as views over `input`.
+    /// @return The number of fields in `input` (which may be more than `capacity`).
+    std::size_t split(std::string_view input, char delimiter, std::string_view* fields, std::size_t capacity) noexcept;
+
+    /// @brief Splits `input` at every `delimiter` into the first `K` strings of `fields`.
+    /// @return The number of fields in `input` (which may be more than `K`).
+    /// @exception `std::out_of_range` if a field is longer than `N`.
+    template <std::size_t N, std::size_t K>
+    std::size_t split(std::string_view input, char delimiter, std::array<static_string<N>, K>& fields);
+
+    namespace __csv_details {
+        /// @brief Iterates the separators of a text (outside of quotes), 64 bytes at a time.
+        class scanner {
+        public:
+            static constexpr std::size_t npos = std::size_t(-1);
+
+            /// @param newlines If `true`, newlines (outside of quotes) are separators as well.
+            scanner(std::string_view input, char delimiter, char quote, bool newlines) noexcept;
+
+            /// @brief The position of the next separator, or `npos` at the end of the input.
+            std::size_t next() noexcept;
+
+        private:
+            /// @brief Computes `mask` for the block at `block`.
+            void load() noexcept;
+
+            std::string_view input;
+            char delimiter;
+            char quote;
+            bool newlines;
+
+            std::size_t block = 0;
+            std::uint64_t mask = 0;
+
+            /// @brief All ones if the previous block ended inside quotes.
+            std::uint64_t inside = 0;
+        };
+
+        /// @brief Removes the surrounding quotes of a quoted field.
+        std::string_view strip_quotes(std::string_view field, char quote) noexcept;
+
+        /// @brief Copies `field` into `out`, removing the quotes of a quoted field.
+        /// @exception `std::out_of_range` if the field is longer than `N`.
+        template <std::size_t N>
+        void assign_field(static_string<N>& out, std::string_view field, char quote);
+    }
+}
+
+class ash::csv_reader {
+public:
+
+// Constructors
+
+    /// @brief Reads the records of `input`, which must outlive the reader.
+    explicit csv_reader(std::string_view input, csv_dialect dialect = {}) noexcept;
+
+// Operations
+
+    /// @brief Reads the next record.
+    /// @param fields Receives the first `capacity` fields as views over the input, without the
+    /// surrounding quotes. Doubled quotes inside them are left as they are.
+    /// @param count Receives the number of fields in the record (which may be more than `capacity`).
+    /// @return `false` at the end of the input.
+    bool next(std::string_view* fields, std::size_t capacity, std::size_t& count) noexcept;
+
+    /// @brief Reads the next record into the first `K` strings of `fields`. Quoted fields are
+    /// unescaped.
+    /// @param count Receives the number of fields in the record (which may be more than `K`).
+    /// @return `false` at the end of the input.
+    /// @exception `std::out_of_range` if a field is longer than `N`.
+    template <std::size_t N, std::size_t K>
+    bool next(std::array<static_string<N>, K>& fields, std::size_t& count);
+
+    /// @brief The number of records read so far.
+    std::size_t records() const noexcept;
+
+private:
+    /// @brief Calls `emit(index, raw_field)` for every field of the next record.
+    template <class Emit>
+    bool next_record(std::size_t& count, Emit&& emit);
+
+    std::string_view input;
+    csv_dialect dialect;
+    __csv_details::scanner scanner;
+
+    std::size_t pos = 0;
+    bool done = false;
+    std::size_t count = 0;
+};
+
+
+inline ash::__csv_details::scanner::scanner(std::string_view input, char delimiter, char quote, bool newlines) noexcept
+    : input(input), delimiter(delimiter), quote(quote), newlines(newlines) {
+    load();
+}
+
+inline std::size_t ash::__csv_details::scanner::next() noexcept {
+    while (mask == 0) {
+        block += 64;
+        if (block >= input.size())
+            return npos;
+
+        load();
+    }
+
+    std::size_t found = block + ash::simd::ctz(mask);
+    mask &= mask - 1;
+
+    return found;
+}
+
+inline void ash::__csv_details::scanner::load() noexcept {
+    if (block >= input.size()) {
+        mask = 0;
+        return;
+    }
+
+    const char* p = input.data() + block;
+    std::size_t left = input.size() - block;
+
+    // The last block is copied, so the loads never go past the input.
+    alignas(16) char tail[64];
+    if (left < 64) {
+        std::memset(tail, 0, 64);
+        std::memcpy(tail, p, left);
+        p = tail;
+    }
+
+    std::uint64_t separators = ash::simd::match_mask64(p, static_cast<unsigned char>(delimiter));
+    if (newlines)
+        separators |= ash::simd::match_mask64(p, '\n');
+
+    if (quote != '\0') {
+        std::uint64_t quoted = ash::simd::prefix_xor(ash::simd::match_mask64(p, static_cast<unsigned char>(quote))) ^ inside;
+        separators &= ~quoted;
+
+        // Sign extension of the last bit.
+        inside = std::uint64_t(0) - (quoted >> 63);
+    }
+
+    if (left < 64)
+        separators &= (std::uint64_t(1) << left) - 1;
+
+    mask = separators;
+}
+
+inline std::string_view ash::__csv_details::strip_quotes(std::string_view field, char quote) noexcept {
+    if (quote != '\0' && field.size() >= 2 && field.front() == quote && field.back() == quote)
+        return field.substr(1, field.size() - 2);
+
+    return field;
+}
+
+template <std::size_t N>
+void ash::__csv_details::assign_field(static_string<N>& out, std::string_view field, char quote) {
+    std::string_view inner = strip_quotes(field, quote);
+
+    if (inner.size() == field.size()) {
+        ash::throw_if_outside_of_capacity(N, field.size());
+
+        out.resize_and_overwrite(field.size(), [&field](char* chars, std::size_t) {
+            std::memcpy(chars, field.data(), field.size());
+            return field.size();
+        });
+
+        return;
+    }
+
+    // Doubled quotes become one. Counting them first keeps the capacity check exact.
+    std::size_t doubled = 0;
+    for (std::size_t i = 0; i + 1 < inner.size(); ++i) {
+        if (inner[i] == quote && inner[i + 1] == quote) {
+            ++doubled;
+            ++i;
+        }
+    }
+
+    std::size_t size = inner.size() - doubled;
+    ash::throw_if_outside_of_capacity(N, size);
+
+    out.resize_and_overwrite(size, [&inner, quote, size](char* chars, std::size_t) {
+        for (std::size_t i = 0; i < inner.size(); ++i) {
+            *chars++ = inner[i];
+            if (inner[i] == quote && i + 1 < inner.size() && inner[i + 1] == quote)
+                ++i;
+        }
+
+        return size;
+    });
+}
+
+inline std::size_t ash::split(std::string_view input, char delimiter, std::string_view* fields, std::size_t capacity) noexcept {
+    __csv_details::scanner scanner(input, delimiter, '\0', false);
+
+    std::size_t count = 0;
+    std::size_t start = 0;
+
+    for (;;) {
+        std::size_t end = scanner.next();
+
+        if (count < capacity)
+            fields[count] = input.substr(start, (end == scanner.npos ? input.size() : end) - start);
+
+        ++count;
+
+        if (end == scanner.npos)
+            return count;
+
+        start = end + 1;
+    }
+}
+
+template <std::size_t N, std::size_t K>
+std::size_t ash::split(std::string_view input, char delimiter, std::array<static_string<N>, K>& fields) {
+    std::string_view views[K == 0 ? 1 : K];
+    std::size_t count = ash::split(input, delimiter, views, K);
+
+    for (std::size_t i = 0; i < count && i < K; ++i)
+        __csv_details::assign_field(fields[i], views[i], '\0');
+
+    return count;
+}
+
+inline ash::csv_reader::csv_reader(std::string_view input, csv_dialect dialect) noexcept
+    : input(input), dialect(dialect), scanner(input, dialect.delimiter, dialect.quote, true), done(input.empty()) {}
+
+inline bool ash::csv_reader::next(std::string_view* fields, std::size_t capacity, std::size_t& count) noexcept {
+    return next_record(count, [this, fields, capacity](std::size_t i, std::string_view raw) {
+        if (i < capacity)
+            fields[i] = __csv_details::strip_quotes(raw, dialect.quote);
+    });
+}
+
+template <std::size_t N, std::size_t K>
+bool ash::csv_reader::next(std::array<static_string<N>, K>& fields, std::size_t& count) {
+    return next_record(count, [this, &fields](std::size_t i, std::string_view raw) {
+        if (i < K)
+            __csv_details::assign_field(fields[i], raw, dialect.quote);
+    });
+}
+
+inline std::size_t ash::csv_reader::records() const noexcept {
+    return count;
+}
+
+template <class Emit>
+bool ash::csv_reader::next_record(std::size_t& fields, Emit&& emit) {
+    if (done)
+        return false;
+
+    fields = 0;
+
+    for (;;) {
+        std::size_t end = scanner.next();
+        bool last = (end == scanner.npos);
+
+        if (last)
+            end = input.size();
+
+        bool record_end = last || input[end] == '\n';
+
+        std::size_t field_end = end;
+        if (record_end && field_end > pos && input[field_end - 1] == '\r')
+            --field_end;
+
+        emit(fields++, input.substr(pos, field_end - pos));
+        pos = end + 1;
+
+        if (record_end) {
+            // A newline at the very end doesn't start another record.
+            done = last || pos >= input.size();
+            ++count;
+            return true;
+        }
+    }
+}
+
+#endif // ASH_CSV
@@ -0,0 +1,436 @@
+/*
+================================================================================
+  ash/edit_distance.h - Bit-parallel edit distances between strings.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    - `ash::levenshtein(a, b)`: the number of insertions, deletions and
+      substitutions that turn `a` into `b`.
+    - `ash::damerau(a, b)`: the same, with transpositions of two adjacent
+      characters (the optimal string alignment distance, where no substring
+      is edited twice).
+    - `ash::within_distance(a, b, k)`: whether the Levenshtein distance is at
+      most `k`. It gives up as soon as the distance can't get back down to
+      `k`.
+
+    Each of them also has a batch form, which compares one query against a
+    `std::vector` of candidates.
+
+    Instead of the `O(m * n)` dynamic programming table, the columns of the
+    table are kept as bit-vectors of their vertical differences (Myers, 1999,
+    and Hyyro, 2003 for transpositions), and a whole column is computed with
+    a handful of word operations. A query of up to 64 characters (all of
+    `basic_static_string<CharT, 64>` and smaller) fits in a single word and
+    doesn't allocate. Longer queries use one word per 64 characters.
+
+    The bit-vectors of the query are computed once per query, so the batch
+    forms only pay for them once. For 1-byte characters they are a table of
+    256 entries; other characters outside [0, 256) are looked up in a list.
+
+  Usage:
+    #include "ash/edit_distance.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_EDIT_DISTANCE
+
+================================================================================
+*/
+
+#ifndef ASH_EDIT_DISTANCE
+#define ASH_EDIT_DISTANCE
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "../ash/static_string.h"
+
+namespace ash {
+    /// @brief The Levenshtein distance between `a` and `b`.
+    template <class CharT>
+    std::size_t levenshtein(std::basic_string_view<CharT> a, std::basic_string_view<CharT> b);
+
+    template <class CharT, std::size_t N, std::size_t M>
+    std::size_t levenshtein(const basic_static_string<CharT, N>& a, const basic_static_string<CharT, M>& b);
+
+    /// @brief The Levenshtein distance between `query` and every candidate, in order.
+    template <class CharT, std::size_t N, std::size_t M, class Allocator>
+    std::vector<std::size_t> levenshtein(const basic_static_string<CharT, N>& query,
+                                         const std::vector<basic_static_string<CharT, M>, Allocator>& candidates);
+
+    /// @brief The optimal string alignment distance (Levenshtein with adjacent transpositions)
+    /// between `a` and `b`.
+    template <class CharT>
+    std::size_t damerau(std::basic_string_view<CharT> a, std::basic_string_view<CharT> b);
+
+    template <class CharT, std::size_t N, std::size_t M>
+    std::size_t damerau(const basic_static_string<CharT, N>& a, const basic_static_string<CharT, M>& b);
+
+    /// @brief The optimal string alignment distance between `query` and every candidate, in order.
+    template <class CharT, std::size_t N, std::size_t M, class Allocator>
+    std::vector<std::size_t> damerau(const basic_static_string<CharT, N>& query,
+                                     const std::vector<basic_static_string<CharT, M>, Allocator>& candidates);
+
+    /// @brief `levenshtein(a, b) <= k`, but faster when it's not.
+    template <class CharT>
+    bool within_distance(std::basic_string_view<CharT> a, std::basic_string_view<CharT> b, std::size_t k);
+
+    template <class CharT, std::size_t N, std::size_t M>
+    bool within_distance(const basic_static_string<CharT, N>& a, const basic_static_string<CharT, M>& b, std::size_t k);
+
+    /// @brief The indices of the candidates whose Levenshtein distance from `query` is at most `k`,
+    /// in ascending order.
+    template <class CharT, std::size_t N, std::size_t M, class Allocator>
+    std::vector<std::size_t> within_distance(const basic_static_string<CharT, N>& query,
+                                             const std::vector<basic_static_string<CharT, M>, Allocator>& candidates,
+                                             std::size_t k);
+
+    namespace __edit_distance_details {
+        /// @brief The bit-vectors of a string: bit `i` of the mask of `c` is set if the `i`th
+        /// character of the string is `c`.
+        template <class CharT>
+        class pattern;
+
+        /// @brief No bound for `distance`.
+        inline constexpr std::size_t unbounded = std::size_t(-1);
+
+        /// @brief The distance between the pattern and `text`, or `bound + 1` if it's certainly
+        /// more than `bound`.
+        template <bool Transpositions, class CharT>
+        std::size_t distance(const pattern<CharT>& p, const CharT* text, std::size_t n, std::size_t bound);
+
+        template <bool Transpositions, class CharT>
+        std::size_t distance_single_word(const pattern<CharT>& p, const CharT* text, std::size_t n, std::size_t bound) noexcept;
+
+        template <bool Transpositions, class CharT>
+        std::size_t distance_multi_word(const pattern<CharT>& p, const CharT* text, std::size_t n, std::size_t bound);
+
+        /// @brief `true` if a distance of `score` after `j` of the `n` columns can't get down to `bound`.
+        inline bool exceeds(std::size_t score, std::size_t j, std::size_t n, std::size_t bound) noexcept {
+            return bound != unbounded && score > n - j && score - (n - j) > bound;
+        }
+    }
+}
+
+template <class CharT>
+class ash::__edit_distance_details::pattern {
+public:
+    explicit pattern(std::basic_string_view<CharT> str);
+
+    std::size_t size() const noexcept { return m; }
+    std::size_t words() const noexcept { return w; }
+
+    /// @brief The `word`th word of the mask of `c`.
+    std::uint64_t get(std::size_t word, CharT c) const noexcept;
+
+    /// @brief The mask of `c`, if the pattern fits in one word.
+    std::uint64_t get(CharT c) const noexcept;
+
+private:
+    using key_type = std::make_unsigned_t<CharT>;
+
+    std::uint64_t& slot(std::size_t word, CharT c);
+
+    std::size_t m;
+    std::size_t w;
+
+    // The masks of [0, 256) when the pattern fits in one word.
+    std::array<std::uint64_t, 256> single;
+
+    // The masks of [0, 256) when it doesn't, `w` words per character.
+    std::vector<std::uint64_t> multi;
+
+    // The other characters (only for characters wider than 1 byte), and their masks.
+    std::vector<CharT> others;
+    std::vector<std::uint64_t> other_masks;
+};
+
+template <class CharT>
+ash::__edit_distance_details::pattern<CharT>::pattern(std::basic_string_view<CharT> str)
+    : m(str.size()), w((str.size() + 63) / 64) {
+    if (w <= 1)
+        single.fill(0);
+    else
+        multi.assign(256 * w, 0);
+
+    for (std::size_t i = 0; i < m; ++i)
+        slot(i / 64, str[i]) |= std::uint64_t(1) << (i % 64);
+}
+
+template <class CharT>
+std::uint64_t ash::__edit_distance_details::pattern<CharT>::get(std::size_t word, CharT c) const noexcept {
+    auto key = static_cast<key_type>(c);
+
+    if (sizeof(CharT) == 1 || key < 256)
+        return (w <= 1) ? single[key] : multi[key * w + word];
+
+    for (std::size_t i = 0; i < others.size(); ++i)
+        if (others[i] == c)
+            return other_masks[i * w + word];
+
+    return 0;
+}
+
+template <class CharT>
+std::uint64_t ash::__edit_distance_details::pattern<CharT>::get(CharT c) const noexcept {
+    auto key = static_cast<key_type>(c);
+
+    if (sizeof(CharT) == 1 || key < 256)
+        return single[key];
+
+    return get(0, c);
+}
+
+template <class CharT>
+std::uint64_t& ash::__edit_distance_details::pattern<CharT>::slot(std::size_t word, CharT c) {
+    auto key = static_cast<key_type>(c);
+
+    if (sizeof(CharT) == 1 || key < 256)
+        return (w <= 1) ? single[key] : multi[key * w + word];
+
+    std::size_t i = 0;
+    while (i < others.size() && others[i] != c)
+        ++i;
+
+    if (i == others.size()) {
+        others.push_back(c);
+        other_masks.resize(other_masks.size() + w, 0);
+    }
+
+    return other_masks[i * w + word];
+}
+
+template <bool Transpositions, class CharT>
+std::size_t ash::__edit_distance_details::distance_single_word(const pattern<CharT>& p, const CharT* text, std::size_t n,
+                                                              std::size_t bound) noexcept {
+    const std::uint64_t last = std::uint64_t(1) << (p.size() - 1);
+
+    // The vertical differences of the current column: +1 in `vp`, -1 in `vn` (0 otherwise).
+    std::uint64_t vp = ~std::uint64_t(0);
+    std::uint64_t vn = 0;
+
+    // The diagonal zero-differences and the mask of the previous column, for transpositions.
+    std::uint64_t d0 = 0;
+    std::uint64_t previous_eq = 0;
+
+    std::size_t score = p.size();
+
+    for (std::size_t j = 0; j < n; ++j) {
+        std::uint64_t eq = p.get(text[j]);
+
+        std::uint64_t transposed = 0;
+        if constexpr (Transpositions)
+            transposed = (((~d0) & eq) << 1) & previous_eq;
+
+        d0 = (((eq & vp) + vp) ^ vp) | eq | vn | transposed;
+
+        // The horizontal differences.
+        std::uint64_t hp = vn | ~(d0 | vp);
+        std::uint64_t hn = d0 & vp;
+
+        score += (hp & last) != 0;
+        score -= (hn & last) != 0;
+
+        // The first row is 0, 1, 2, ..., so it always increases by 1.
+        hp = (hp << 1) | 1;
+        hn <<= 1;
+
+        vp = hn | ~(d0 | hp);
+        vn = hp & d0;
+        previous_eq = eq;
+
+        if (exceeds(score, j + 1, n, bound))
+            return bound + 1;
+    }
+
+    return score;
+}
+
+template <bool Transpositions, class CharT>
+std::size_t ash::__edit_distance_details::distance_multi_word(const pattern<CharT>& p, const CharT* text, std::size_t n,
+                                                             std::size_t bound) {
+    const std::size_t words = p.words();
+    const std::uint64_t last = std::uint64_t(1) << ((p.size() - 1) % 64);
+
+    struct column_word {
+        std::uint64_t vp = ~std::uint64_t(0);
+        std::uint64_t vn = 0;
+        std::uint64_t d0 = 0;
+        std::uint64_t previous_eq = 0;
+    };
+
+    std::vector<column_word> column(words);
+    std::size_t score = p.size();
+
+    for (std::size_t j = 0; j < n; ++j) {
+        // The horizontal differences carried from one word into the next one (the first row
+        // always increases by 1).
+        std::uint64_t hp_carry = 1;
+        std::uint64_t hn_carry = 0;
+
+        // The values of the word below, for the transpositions crossing the word boundary.
+        std::uint64_t lower_eq = 0;
+        std::uint64_t lower_d0 = 0;
+
+        for (std::size_t k = 0; k < words; ++k) {
+            column_word& c = column[k];
+            std::uint64_t eq = p.get(k, text[j]);
+
+            std::uint64_t transposed = 0;
+            if constexpr (Transpositions)
+                transposed = ((((~c.d0) & eq) << 1) | (((~lower_d0) & lower_eq) >> 63)) & c.previous_eq;
+
+            lower_eq = eq;
+            lower_d0 = c.d0;
+
+            // A -1 coming from below acts as a match in the lowest row of this word (Myers' carry).
+            std::uint64_t x = eq | hn_carry;
+            c.d0 = (((x & c.vp) + c.vp) ^ c.vp) | x | c.vn | transposed;
+
+            std::uint64_t hp = c.vn | ~(c.d0 | c.vp);
+            std::uint64_t hn = c.d0 & c.vp;
+
+            if (k == words - 1) {
+                score += (hp & last) != 0;
+                score -= (hn & last) != 0;
+            }
+
+            std::uint64_t hp_out = hp >> 63;
+            std::uint64_t hn_out = hn >> 63;
+            hp = (hp << 1) | hp_carry;
+            hn = (hn << 1) | hn_carry;
+            hp_carry = hp_out;
+            hn_carry = hn_out;
+
+            c.vp = hn | ~(c.d0 | hp);
+            c.vn = hp & c.d0;
+            c.previous_eq = eq;
+        }
+
+        if (exceeds(score, j + 1, n, bound))
+            return bound + 1;
+    }
+
+    return score;
+}
+
+template <bool Transpositions, class CharT>
+std::size_t ash::__edit_distance_details::distance(const pattern<CharT>& p, const CharT* text, std::size_t n, std::size_t bound) {
+    std::size_t m = p.size();
+
+    // The distance is at least the difference of the sizes.
+    if (bound != unbounded && (m > n ? m - n : n - m) > bound)
+        return bound + 1;
+
+    if (m == 0)
+        return n;
+
+    if (n == 0)
+        return m;
+
+    if (p.words() == 1)
+        return distance_single_word<Transpositions>(p, text, n, bound);
+
+    return distance_multi_word<Transpositions>(p, text, n, bound);
+}
+
+template <class CharT>
+std::size_t ash::levenshtein(std::basic_string_view<CharT> a, std::basic_string_view<CharT> b) {
+    // The shorter string is the pattern, so that it fits in a word more often.
+    if (a.size() > b.size())
+        a.swap(b);
+
+    __edit_distance_details::pattern<CharT> p(a);
+    return __edit_distance_details::distance<false>(p, b.data(), b.size(), __edit_distance_details::unbounded);
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+std::size_t ash::levenshtein(const basic_static_string<CharT, N>& a, const basic_static_string<CharT, M>& b) {
+    return ash::levenshtein(std::basic_string_view<CharT>(a.data(), a.size()), std::basic_string_view<CharT>(b.data(), b.size()));
+}
+
+template <class CharT, std::size_t N, std::size_t M, class Allocator>
+std::vector<std::size_t> ash::levenshtein(const basic_static_string<CharT, N>& query,
+                                          const std::vector<basic_static_string<CharT, M>, Allocator>& candidates) {
+    __edit_distance_details::pattern<CharT> p(std::basic_string_view<CharT>(query.data(), query.size()));
+
+    std::vector<std::size_t> result;
+    result.reserve(candidates.size());
+
+    for (const auto& candidate : candidates)
+        result.push_back(__edit_distance_details::distance<false>(p, candidate.data(), candidate.size(),
+                                                                  __edit_distance_details::unbounded));
+
+    return result;
+}
+
+template <class CharT>
+std::size_t ash::damerau(std::basic_string_view<CharT> a, std::basic_string_view<CharT> b) {
+    if (a.size() > b.size())
+        a.swap(b);
+
+    __edit_distance_details::pattern<CharT> p(a);
+    return __edit_distance_details::distance<true>(p, b.data(), b.size(), __edit_distance_details::unbounded);
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+std::size_t ash::damerau(const basic_static_string<CharT, N>& a, const basic_static_string<CharT, M>& b) {
+    return ash::damerau(std::basic_string_view<CharT>(a.data(), a.size()), std::basic_string_view<CharT>(b.data(), b.size()));
+}
+
+template <class CharT, std::size_t N, std::size_t M, class Allocator>
+std::vector<std::size_t> ash::damerau(const basic_static_string<CharT, N>& query,
+                                      const std::vector<basic_static_string<CharT, M>, Allocator>& candidates) {
+    __edit_distance_details::pattern<CharT> p(std::basic_string_view<CharT>(query.data(), query.size()));
+
+    std::vector<std::size_t> result;
+    result.reserve(candidates.size());
+
+    for (const auto& candidate : candidates)
+        result.push_back(__edit_distance_details::distance<true>(p, candidate.data(), candidate.size(),
+                                                                 __edit_distance_details::unbounded));
+
+    return result;
+}
+
+template <class CharT>
+bool ash::within_distance(std::basic_string_view<CharT> a, std::basic_string_view<CharT> b, std::size_t k) {
+    if (a.size() > b.size())
+        a.swap(b);
+
+    // Saves building the pattern.
+    if (b.size() - a.size() > k)
+        return false;
+
+    __edit_distance_details::pattern<CharT> p(a);
+    return __edit_distance_details::distance<false>(p, b.data(), b.size(), k) <= k;
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+bool ash::within_distance(const basic_static_string<CharT, N>& a, const basic_static_string<CharT, M>& b, std::size_t k) {
+    return ash::within_distance(std::basic_string_view<CharT>(a.data(), a.size()), std::basic_string_view<CharT>(b.data(), b.size()), k);
+}
+
+template <class CharT, std::size_t N, std::size_t M, class Allocator>
+std::vector<std::size_t> ash::within_distance(const basic_static_string<CharT, N>& query,
+                                              const std::vector<basic_static_string<CharT, M>, Allocator>& candidates,
+                                              std::size_t k) {
+    __edit_distance_details::pattern<CharT> p(std::basic_string_view<CharT>(query.data(), query.size()));
+
+    std::vector<std::size_t> result;
+
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+        if (__edit_distance_details::distance<false>(p, candidates[i].data(), candidates[i].size(), k) <= k)
+            result.push_back(i);
+
+    return result;
+}
+
+#endif // ASH_EDIT_DISTANCE
@@ -0,0 +1,217 @@
+/*
+================================================================================
+  ash/fd_writer.h - Batches many small strings into one `writev` call.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::fd_writer` collects strings (e.g. `ash::static_string`s, one per log
+    line) and writes all of them to a file descriptor with a single
+    `writev`, instead of one `write` per string.
+
+    - `write` copies the string into the writer's buffer. Strings which are
+      written one after another end up next to each other, so they take a
+      single `iovec`.
+    - `write_ref` doesn't copy at all, it only remembers where the string is.
+      The string must stay alive (and unchanged) until the next `flush`.
+
+    The writer flushes by itself when its buffer or its `iovec` list is
+    full, and when it is destroyed.
+
+  Usage:
+    #include "ash/fd_writer.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_FD_WRITER
+
+================================================================================
+*/
+
+#ifndef ASH_FD_WRITER
+#define ASH_FD_WRITER
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace ash {
+    /// @class fd_writer
+    /// @brief Writes batches of strings to a file descriptor with `writev`.
+    class fd_writer;
+}
+
+class ash::fd_writer {
+public:
+    using size_type = std::size_t;
+
+    /// @brief The maximum number of `iovec`s in one `writev` call.
+#ifdef IOV_MAX
+    static constexpr size_type max_iovecs = IOV_MAX;
+#else
+    static constexpr size_type max_iovecs = 1024;
+#endif
+
+// Constructors
+
+    /// @brief Writes to `fd`, which stays open and owned by the caller.
+    /// @param buffer_size The number of bytes `write` can copy before a flush is needed.
+    explicit fd_writer(int fd, size_type buffer_size = size_type(1) << 16);
+
+    fd_writer(const fd_writer&) = delete;
+    fd_writer& operator=(const fd_writer&) = delete;
+
+    /// @brief Flushes. Errors are ignored here, call `flush` first to see them.
+    ~fd_writer();
+
+// Capacity
+
+    /// @brief The number of bytes waiting for the next flush.
+    size_type pending() const noexcept;
+
+// Modifiers
+
+    /// @brief Copies `str` to be written with the next flush. `ash::basic_static_string<char, N>`
+    /// converts to `std::string_view` implicitly.
+    /// @exception `std::system_error` if a flush is needed and fails.
+    void write(std::string_view str);
+
+    /// @brief Same as `write(str)` followed by a newline.
+    void write_line(std::string_view str);
+
+    /// @brief Queues `str` without copying it. It must stay valid until the next flush.
+    /// @exception `std::system_error` if a flush is needed and fails.
+    void write_ref(std::string_view str);
+
+    /// @brief Writes everything that is pending, with as few `writev` calls as possible.
+    /// @exception `std::system_error` if `writev` fails. The data which wasn't written is dropped.
+    void flush();
+
+private:
+    /// @brief Appends [`data`, `data + size`) to the `iovec` list, merging it with the last
+    /// entry if they are adjacent.
+    void queue(const char* data, size_type size);
+
+    int fd;
+
+    /// @brief Never reallocated, since the queued `iovec`s point into it.
+    std::unique_ptr<char[]> buffer;
+    size_type capacity;
+    size_type used = 0;
+
+    std::vector<iovec> iovecs;
+    size_type bytes = 0;
+};
+
+
+inline ash::fd_writer::fd_writer(int fd, size_type buffer_size)
+    : fd(fd), buffer(new char[buffer_size]), capacity(buffer_size) {
+    iovecs.reserve(max_iovecs);
+}
+
+inline ash::fd_writer::~fd_writer() {
+    try {
+        flush();
+    }
+    catch (...) {}
+}
+
+inline ash::fd_writer::size_type ash::fd_writer::pending() const noexcept {
+    return bytes;
+}
+
+inline void ash::fd_writer::write(std::string_view str) {
+    // Flushing resets the buffer, so it must happen before the copy (not in `queue`).
+    if (str.size() > capacity - used || iovecs.size() == max_iovecs) {
+        flush();
+
+        // Too large for the buffer even when it's empty, so it's written from where it is.
+        if (str.size() > capacity) {
+            queue(str.data(), str.size());
+            flush();
+            return;
+        }
+    }
+
+    char* target = buffer.get() + used;
+    std::memcpy(target, str.data(), str.size());
+    used += str.size();
+
+    queue(target, str.size());
+}
+
+inline void ash::fd_writer::write_line(std::string_view str) {
+    write(str);
+    write(std::string_view("\n", 1));
+}
+
+inline void ash::fd_writer::write_ref(std::string_view str) {
+    queue(str.data(), str.size());
+}
+
+inline void ash::fd_writer::flush() {
+    size_type first = 0;
+
+    while (first < iovecs.size()) {
+        int count = static_cast<int>(std::min(iovecs.size() - first, max_iovecs));
+        ssize_t written = ::writev(fd, iovecs.data() + first, count);
+
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            int error = errno;
+            iovecs.clear();
+            used = 0;
+            bytes = 0;
+
+            throw std::system_error(error, std::generic_category(), "writev");
+        }
+
+        // Skips what was written. The last `iovec` may have been written partially.
+        auto left = static_cast<size_type>(written);
+        while (first < iovecs.size() && left >= iovecs[first].iov_len)
+            left -= iovecs[first++].iov_len;
+
+        if (left) {
+            iovecs[first].iov_base = static_cast<char*>(iovecs[first].iov_base) + left;
+            iovecs[first].iov_len -= left;
+        }
+    }
+
+    iovecs.clear();
+    used = 0;
+    bytes = 0;
+}
+
+inline void ash::fd_writer::queue(const char* data, size_type size) {
+    if (size == 0)
+        return;
+
+    if (!iovecs.empty()) {
+        iovec& last = iovecs.back();
+        if (static_cast<char*>(last.iov_base) + last.iov_len == data) {
+            last.iov_len += size;
+            bytes += size;
+            return;
+        }
+    }
+
+    if (iovecs.size() == max_iovecs)
+        flush();
+
+    iovecs.push_back(iovec { const_cast<char*>(data), size });
+    bytes += size;
+}
+
+#endif // ASH_FD_WRITER
@@ -0,0 +1,496 @@
+/*
+================================================================================
+  ash/format.h - Compile-time checked formatting into `ash::static_string`s.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::format<"{}:{:08x} {}">(args...)` formats its arguments into a
+    `static_string<C>` and never allocates:
+
+    - The format string is a template argument, so it is parsed and checked
+      against the argument types at compile time. A wrong format string is
+      a compile error, not an exception.
+    - The capacity `C` is computed from the format string and the argument
+      types (e.g. an `int` takes at most 11 characters in decimal), so the
+      output always fits.
+    - Numbers are converted with `std::to_chars`.
+
+    Replacement fields are `{}` or `{:spec}` with
+        spec = [[fill]align][0][width][.precision][type]
+        align = '<' | '>' | '^'
+        type  = 'd' | 'x' | 'X' | 'b' | 'o'   (integers)
+              | 'f' | 'e' | 'g'               (floating-point numbers)
+              | 's'                           (strings, characters, bool)
+
+    Arguments can be integers, floating-point numbers, `bool`, `char`,
+    `basic_static_string<char, M>` and `char` arrays (string literals).
+    `const char*` and `std::string_view` have no bound, so they need a
+    precision (the maximum number of characters), e.g. `{:.32}`.
+
+    `{{` and `}}` are literal braces. Positional fields (`{0}`) are not
+    supported.
+
+  Usage:
+    #include "ash/format.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_FORMAT
+
+================================================================================
+*/
+
+#ifndef ASH_FORMAT
+#define ASH_FORMAT
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "../ash/static_string.h"
+
+namespace ash {
+    /// @struct format_string
+    /// @brief A string literal as a template argument of `ash::format`.
+    /// @tparam L Size of the literal, including the null character.
+    template <std::size_t L>
+    struct format_string {
+        char chars[L] {};
+
+        consteval format_string(const char (&str)[L]) {
+            for (std::size_t i = 0; i < L; ++i)
+                chars[i] = str[i];
+        }
+
+        static constexpr std::size_t size() noexcept { return L - 1; }
+    };
+
+    namespace __format_details {
+        struct spec {
+            char fill = ' ';
+
+            /// @brief `'<'`, `'>'`, `'^'`, or `0` for the default of the type.
+            char align = 0;
+            bool zero = false;
+            std::size_t width = 0;
+            std::size_t precision = std::size_t(-1);
+            char type = 0;
+        };
+
+        enum class kind {
+            boolean,
+            character,
+            signed_integer,
+            unsigned_integer,
+            floating,
+
+            /// @brief A string with a known maximum size.
+            bounded_string,
+
+            /// @brief A string without a known maximum size (needs a precision).
+            unbounded_string
+        };
+
+        struct arg_info {
+            kind k;
+
+            /// @brief Bits of integers, the maximum size of bounded strings.
+            std::size_t size;
+        };
+
+        /// @brief The format string after parsing. Field `i` is preceded by the literal text
+        /// [`literal_begin[i]`, `literal_end[i]`) of `text`, the last literal follows the last field.
+        template <std::size_t L>
+        struct parsed {
+            char text[L] {};
+            std::size_t literal_begin[L] {};
+            std::size_t literal_end[L] {};
+            spec specs[L] {};
+            std::size_t fields = 0;
+        };
+
+        template <format_string Fmt>
+        consteval parsed<Fmt.size() + 1> parse();
+
+        template <class T>
+        consteval arg_info info_of();
+
+        /// @brief The maximum number of characters of a field. Also checks the spec against the type
+        /// (the errors are only meant for constant evaluation).
+        constexpr std::size_t field_capacity(const spec& s, arg_info info);
+
+        template <format_string Fmt, class... Args>
+        consteval std::size_t capacity();
+
+        template <class T>
+        char* write_field(char* out, const spec& s, const T& value) noexcept;
+    }
+
+    /// @brief The capacity of the result of `format<Fmt>(args...)` with arguments of types `Args`.
+    template <format_string Fmt, class... Args>
+    constexpr std::size_t format_capacity = __format_details::capacity<Fmt, std::remove_cvref_t<Args>...>();
+
+    /// @brief Formats `args` according to `Fmt`.
+    /// @return A `static_string` which is large enough for any values of `Args`.
+    template <format_string Fmt, class... Args>
+    static_string<format_capacity<Fmt, Args...>> format(const Args&... args) noexcept;
+}
+
+template <ash::format_string Fmt>
+consteval ash::__format_details::parsed<Fmt.size() + 1> ash::__format_details::parse() {
+    parsed<Fmt.size() + 1> result;
+
+    constexpr std::size_t n = Fmt.size();
+    const char* f = Fmt.chars;
+
+    std::size_t out = 0;
+    std::size_t begin = 0;
+
+    auto digits = [&](std::size_t& i) {
+        std::size_t value = 0;
+        while (i < n && f[i] >= '0' && f[i] <= '9')
+            value = value * 10 + (f[i++] - '0');
+
+        return value;
+    };
+
+    for (std::size_t i = 0; i < n;) {
+        if (f[i] == '}') {
+            if (i + 1 < n && f[i + 1] == '}') {
+                result.text[out++] = '}';
+                i += 2;
+                continue;
+            }
+
+            throw "ash::format: An unmatched '}' in the format string.";
+        }
+
+        if (f[i] != '{') {
+            result.text[out++] = f[i++];
+            continue;
+        }
+
+        if (i + 1 < n && f[i + 1] == '{') {
+            result.text[out++] = '{';
+            i += 2;
+            continue;
+        }
+
+        // A replacement field.
+        spec s;
+        ++i;
+
+        if (i < n && f[i] == ':') {
+            ++i;
+
+            auto is_align = [](char c) { return c == '<' || c == '>' || c == '^'; };
+
+            if (i + 1 < n && is_align(f[i + 1]) && f[i] != '{' && f[i] != '}') {
+                s.fill = f[i];
+                s.align = f[i + 1];
+                i += 2;
+            }
+            else if (i < n && is_align(f[i])) {
+                s.align = f[i++];
+            }
+
+            if (i < n && f[i] == '0') {
+                s.zero = true;
+                ++i;
+            }
+
+            s.width = digits(i);
+
+            if (i < n && f[i] == '.') {
+                ++i;
+                if (i >= n || f[i] < '0' || f[i] > '9')
+                    throw "ash::format: A '.' must be followed by the precision.";
+
+                s.precision = digits(i);
+            }
+
+            if (i < n && f[i] != '}')
+                s.type = f[i++];
+        }
+
+        if (i >= n || f[i] != '}')
+            throw "ash::format: A replacement field must be '{}' or '{:spec}'.";
+
+        ++i;
+
+        result.literal_begin[result.fields] = begin;
+        result.literal_end[result.fields] = out;
+        result.specs[result.fields] = s;
+        ++result.fields;
+
+        begin = out;
+    }
+
+    result.literal_begin[result.fields] = begin;
+    result.literal_end[result.fields] = out;
+
+    return result;
+}
+
+template <class T>
+consteval ash::__format_details::arg_info ash::__format_details::info_of() {
+    if constexpr (std::is_same_v<T, bool>)
+        return { kind::boolean, 0 };
+    else if constexpr (std::is_same_v<T, char>)
+        return { kind::character, 0 };
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        return { kind::signed_integer, sizeof(T) * 8 };
+    else if constexpr (std::is_integral_v<T>)
+        return { kind::unsigned_integer, sizeof(T) * 8 };
+    else if constexpr (std::is_floating_point_v<T>)
+        return { kind::floating, sizeof(T) * 8 };
+    else if constexpr (ash::is_basic_static_string<T>::value) {
+        static_assert(std::is_same_v<typename T::value_type, char>, "ash::format: Only char strings are supported.");
+        return { kind::bounded_string, T::capacity() };
+    }
+    else if constexpr (std::is_array_v<T> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>)
+        return { kind::bounded_string, std::extent_v<T> - 1 };
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        return { kind::unbounded_string, 0 };
+    else
+        static_assert(sizeof(T) == 0, "ash::format: Unsupported argument type.");
+}
+
+constexpr std::size_t ash::__format_details::field_capacity(const spec& s, arg_info info) {
+    std::size_t content = 0;
+    bool has_precision = (s.precision != std::size_t(-1));
+
+    switch (info.k) {
+        case kind::signed_integer:
+        case kind::unsigned_integer: {
+            if (has_precision)
+                throw "ash::format: Integers can't have a precision.";
+
+            std::size_t bits = info.size;
+            switch (s.type) {
+                case 0:
+                case 'd':
+                    // digits10 of a `bits`-bit integer, plus one.
+                    content = bits * 30103 / 100000 + 1;
+                    break;
+                case 'x':
+                case 'X':
+                    content = bits / 4;
+                    break;
+                case 'b':
+                    content = bits;
+                    break;
+                case 'o':
+                    content = (bits + 2) / 3;
+                    break;
+                default:
+                    throw "ash::format: Unsupported type for an integer.";
+            }
+
+            if (info.k == kind::signed_integer)
+                ++content;
+
+            break;
+        }
+
+        case kind::floating: {
+            // Exponent digits of the largest supported type (long double: 4932).
+            std::size_t exponent = (info.size > 64) ? 4 : 3;
+            std::size_t max_integer = (info.size > 64) ? 4933 : (info.size > 32 ? 309 : 39);
+            std::size_t max_digits = (info.size > 64) ? 36 : (info.size > 32 ? 17 : 9);
+
+            switch (s.type) {
+                case 0:
+                    // Shortest round-trip, or `g` with a precision.
+                    content = 1 + (has_precision ? (s.precision > 1 ? s.precision : 1) : max_digits) + 1 + 2 + exponent;
+                    break;
+                case 'g':
+                    // Scientific, or fixed with at most 4 leading zeros ("0.0001234").
+                    content = 1 + (has_precision && s.precision > 1 ? s.precision : (has_precision ? 1 : 6)) + 1 + 2 + exponent;
+                    break;
+                case 'e':
+                    content = 1 + 1 + 1 + (has_precision ? s.precision : 6) + 2 + exponent;
+                    break;
+                case 'f':
+                    content = 1 + max_integer + 1 + (has_precision ? s.precision : 6);
+                    break;
+                default:
+                    throw "ash::format: Unsupported type for a floating-point number.";
+            }
+
+            break;
+        }
+
+        case kind::boolean:
+        case kind::character:
+            if (has_precision)
+                throw "ash::format: Characters and bool can't have a precision.";
+            if (s.type != 0 && s.type != 's')
+                throw "ash::format: Unsupported type for a character or bool.";
+            if (s.zero)
+                throw "ash::format: Zero padding is only for numbers.";
+
+            content = (info.k == kind::boolean) ? 5 : 1;
+            break;
+
+        case kind::bounded_string:
+        case kind::unbounded_string:
+            if (s.type != 0 && s.type != 's')
+                throw "ash::format: Unsupported type for a string.";
+            if (s.zero)
+                throw "ash::format: Zero padding is only for numbers.";
+
+            if (info.k == kind::unbounded_string) {
+                if (!has_precision)
+                    throw "ash::format: Strings without a maximum size (const char*, string_view) need a precision, e.g. '{:.32}'.";
+
+                content = s.precision;
+            }
+            else {
+                content = has_precision && s.precision < info.size ? s.precision : info.size;
+            }
+
+            break;
+    }
+
+    return content > s.width ? content : s.width;
+}
+
+template <ash::format_string Fmt, class... Args>
+consteval std::size_t ash::__format_details::capacity() {
+    constexpr auto p = parse<Fmt>();
+
+    if (p.fields != sizeof...(Args))
+        throw "ash::format: The number of replacement fields and arguments don't match.";
+
+    const arg_info infos[] = { info_of<Args>()..., arg_info { kind::character, 0 } };
+
+    std::size_t total = p.literal_end[p.fields] - p.literal_begin[p.fields];
+    for (std::size_t i = 0; i < p.fields; ++i)
+        total += (p.literal_end[i] - p.literal_begin[i]) + field_capacity(p.specs[i], infos[i]);
+
+    return total;
+}
+
+template <class T>
+char* ash::__format_details::write_field(char* out, const spec& s, const T& value) noexcept {
+    constexpr arg_info info = info_of<T>();
+
+    // The content is written first, then moved into place if it needs padding.
+    char* begin = out;
+    char* limit = out + field_capacity(s, info);
+    char* end = out;
+    bool number = false;
+
+    if constexpr (info.k == kind::boolean) {
+        std::string_view text = value ? "true" : "false";
+        std::memcpy(out, text.data(), text.size());
+        end = out + text.size();
+    }
+    else if constexpr (info.k == kind::character) {
+        *end++ = value;
+    }
+    else if constexpr (info.k == kind::signed_integer || info.k == kind::unsigned_integer) {
+        int base = (s.type == 'x' || s.type == 'X') ? 16 : (s.type == 'b' ? 2 : (s.type == 'o' ? 8 : 10));
+        end = std::to_chars(out, limit, value, base).ptr;
+
+        if (s.type == 'X')
+            for (char* c = out; c != end; ++c)
+                if (*c >= 'a' && *c <= 'f')
+                    *c = static_cast<char>(*c - 'a' + 'A');
+
+        number = true;
+    }
+    else if constexpr (info.k == kind::floating) {
+        bool has_precision = (s.precision != std::size_t(-1));
+        int precision = has_precision ? static_cast<int>(s.precision) : 6;
+
+        switch (s.type) {
+            case 'f': end = std::to_chars(out, limit, value, std::chars_format::fixed, precision).ptr; break;
+            case 'e': end = std::to_chars(out, limit, value, std::chars_format::scientific, precision).ptr; break;
+            case 'g': end = std::to_chars(out, limit, value, std::chars_format::general, precision).ptr; break;
+            default:
+                end = has_precision
+                    ? std::to_chars(out, limit, value, std::chars_format::general, precision).ptr
+                    : std::to_chars(out, limit, value).ptr;
+        }
+
+        number = true;
+    }
+    else {
+        std::string_view text;
+
+        // A string literal may be shorter than its array.
+        if constexpr (std::is_array_v<T>) {
+            const void* null = std::memchr(value, '\0', info.size);
+            text = std::string_view(value, null ? static_cast<const char*>(null) - value : info.size);
+        }
+        else {
+            text = value;
+        }
+
+        if (s.precision < text.size())
+            text = text.substr(0, s.precision);
+
+        std::memcpy(out, text.data(), text.size());
+        end = out + text.size();
+    }
+
+    std::size_t size = end - begin;
+    if (size >= s.width)
+        return end;
+
+    std::size_t padding = s.width - size;
+
+    if (number && s.zero && s.align == 0) {
+        // Zeros go after the sign: "-0042".
+        std::size_t sign = (*begin == '-') ? 1 : 0;
+        std::memmove(begin + sign + padding, begin + sign, size - sign);
+        std::memset(begin + sign, '0', padding);
+        return end + padding;
+    }
+
+    char align = s.align ? s.align : (number ? '>' : '<');
+    std::size_t before = (align == '>') ? padding : (align == '^' ? padding / 2 : 0);
+
+    std::memmove(begin + before, begin, size);
+    std::memset(begin, s.fill, before);
+    std::memset(begin + before + size, s.fill, padding - before);
+
+    return end + padding;
+}
+
+template <ash::format_string Fmt, class... Args>
+ash::static_string<ash::format_capacity<Fmt, Args...>> ash::format(const Args&... args) noexcept {
+    static constexpr auto p = __format_details::parse<Fmt>();
+
+    static_string<format_capacity<Fmt, Args...>> result;
+    result.resize_and_overwrite(result.capacity(), [&](char* out, std::size_t) {
+        char* first = out;
+
+        auto literal = [&out](std::size_t i) {
+            std::size_t size = p.literal_end[i] - p.literal_begin[i];
+            std::memcpy(out, p.text + p.literal_begin[i], size);
+            out += size;
+        };
+
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((literal(I), out = __format_details::write_field(out, p.specs[I], args)), ...);
+        }(std::index_sequence_for<Args...> {});
+
+        literal(sizeof...(Args));
+
+        return static_cast<std::size_t>(out - first);
+    });
+
+    return result;
+}
+
+#endif // ASH_FORMAT
@@ -0,0 +1,587 @@
+/*
+================================================================================
+  ash/fsst.h - FSST-style compression for columns of `ash::static_string`s.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    FSST ("Fast Static Symbol Table", Boncz, Neumann and Leis, VLDB 2020)
+    replaces frequent substrings of up to 8 bytes with 1-byte codes:
+
+    - `ash::fsst_symbol_table` holds up to 255 symbols. It is built from a
+      sample of strings in a few rounds: every round compresses the sample
+      with the current table, counts how often each symbol and each pair of
+      consecutive symbols were used, and keeps the 255 candidates with the
+      highest gain (`count * length`).
+    - Bytes that are not covered by any symbol are written as the escape
+      code (`255`) followed by the byte itself.
+    - Decoding is a table lookup per code, which copies 8 bytes
+      unconditionally and advances by the length of the symbol. This is
+      what makes it run at GB/s.
+
+    `ash::fsst_column<N>` stores many `static_string<N>`s compressed in one
+    byte stream with an offset per string, and decodes any of them on its
+    own (random access).
+
+  Usage:
+    #include "ash/fsst.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_FSST
+
+================================================================================
+*/
+
+#ifndef ASH_FSST
+#define ASH_FSST
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @class fsst_symbol_table
+    /// @brief Up to 255 symbols of 1 to 8 bytes, and the code of each.
+    class fsst_symbol_table;
+
+    /// @class fsst_column
+    /// @brief A column of compressed `static_string<N>`s with random access decoding.
+    /// @tparam N Capacity of the strings.
+    template <std::size_t N>
+    class fsst_column;
+}
+
+class ash::fsst_symbol_table {
+public:
+
+// Constants
+
+    /// @brief The code which means "the next byte is a literal".
+    static constexpr std::uint8_t escape = 255;
+
+    /// @brief The maximum number of symbols.
+    static constexpr std::size_t max_symbols = 255;
+
+    /// @brief The maximum length of a symbol.
+    static constexpr std::size_t max_symbol_length = 8;
+
+    /// @brief `decode_unchecked` may write this many bytes after the end of the decoded string.
+    static constexpr std::size_t decode_slack = max_symbol_length - 1;
+
+    /// @brief The number of rounds of `build`.
+    static constexpr std::size_t build_rounds = 5;
+
+// Constructors
+
+    /// @brief Constructs a table without any symbols. Everything is escaped.
+    fsst_symbol_table() noexcept;
+
+    /// @brief Builds a table for strings similar to `sample`.
+    /// @param sample Any range of `basic_static_string<char, N>`, `std::string_view`, or anything
+    /// else that has `data()` and `size()`. A few thousand values are usually enough.
+    template <class Range>
+    static fsst_symbol_table build(const Range& sample);
+
+// Capacity
+
+    /// @brief Number of symbols.
+    std::size_t size() const noexcept;
+
+    /// @brief The worst-case encoded size of `len` bytes (every byte escaped).
+    static constexpr std::size_t max_encoded_size(std::size_t len) noexcept { return 2 * len; }
+
+// Operations
+
+    /// @brief Compresses [`in`, `in + len`).
+    /// @param out Must have room for `max_encoded_size(len)` bytes.
+    /// @return The number of bytes written.
+    std::size_t encode(const char* in, std::size_t len, std::uint8_t* out) const noexcept;
+
+    /// @brief Decompresses [`in`, `in + len`) without checking the output size.
+    /// @param out Must have room for the decoded size plus `decode_slack` bytes.
+    /// @return The decoded size.
+    std::size_t decode_unchecked(const std::uint8_t* in, std::size_t len, char* out) const noexcept;
+
+    /// @brief Decompresses [`in`, `in + len`) into at most `capacity` bytes.
+    /// @return The decoded size, or `capacity + 1` if the output doesn't fit.
+    std::size_t decode(const std::uint8_t* in, std::size_t len, char* out, std::size_t capacity) const noexcept;
+
+    /// @brief The bytes of the symbol with code `code`.
+    std::string_view symbol(std::uint8_t code) const noexcept;
+
+private:
+    struct candidate {
+        std::uint64_t value;
+        std::uint8_t length;
+        std::uint64_t gain;
+    };
+
+    /// @brief Finds the longest symbol at the beginning of [`p`, `p + remaining`).
+    /// @return Its length, or `0` if there is none.
+    std::size_t match(const std::uint8_t* p, std::size_t remaining, std::uint8_t& code) const noexcept;
+
+    /// @brief Rebuilds the lookup index of `match` after the symbols changed.
+    void index();
+
+    static std::uint64_t mask(std::size_t length) noexcept;
+    static std::uint8_t first_byte(std::uint64_t value) noexcept;
+
+    /// @brief The bytes of every symbol, padded with zeros to 8 bytes.
+    std::uint64_t values[256];
+    std::uint8_t lengths[256];
+    std::size_t count = 0;
+
+    /// @brief Codes ordered by first byte and then by length (longest first). The codes of the
+    /// symbols starting with byte `b` are [`order + first_begin[b]`, `order + first_begin[b + 1]`).
+    std::uint8_t order[256];
+    std::uint16_t first_begin[257];
+};
+
+template <std::size_t N>
+class ash::fsst_column {
+public:
+    using value_type = static_string<N>;
+    using size_type = std::size_t;
+
+    /// @brief Size of a buffer that `decode(i, buffer)` can always decode into.
+    static constexpr size_type buffer_size = N + fsst_symbol_table::decode_slack;
+
+// Constructors
+
+    /// @brief Constructs an empty column which compresses with `symbols`.
+    explicit fsst_column(const fsst_symbol_table& symbols);
+
+    /// @brief Builds a symbol table from (an evenly spread sample of) `values`, then compresses all
+    /// of them.
+    /// @param values Any range of `static_string<M>` (with `M <= N`) or string views.
+    /// @param sample_size The maximum number of values used to build the symbol table.
+    template <class Range>
+    static fsst_column build(const Range& values, size_type sample_size = 4096);
+
+// Element access
+
+    /// @brief Decompresses string `i`. No bounds checking is performed.
+    value_type operator[](size_type i) const;
+
+    /// @brief Decompresses string `i`.
+    /// @exception `std::out_of_range` if `i` is equal or more than `size()`.
+    value_type at(size_type i) const;
+
+    /// @brief Decompresses string `i` into `buffer`. No bounds checking is performed.
+    /// @param buffer At least `buffer_size` characters.
+    /// @return A view over the decoded string in `buffer`.
+    std::string_view decode(size_type i, char* buffer) const noexcept;
+
+    /// @brief The table used for compression.
+    const fsst_symbol_table& symbols() const noexcept;
+
+// Capacity
+
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+
+    /// @brief Size of the compressed data, including the offsets.
+    size_type compressed_bytes() const noexcept;
+
+// Modifiers
+
+    /// @brief Compresses and appends a string.
+    /// @exception `std::out_of_range` if `str.size()` is more than `N`.
+    void push_back(std::string_view str);
+
+    /// @brief Compresses and appends a string.
+    template <std::size_t M>
+    void push_back(const static_string<M>& str);
+
+    void reserve(size_type count, size_type bytes);
+    void clear() noexcept;
+
+private:
+    fsst_symbol_table table;
+    std::vector<std::uint8_t> bytes;
+    std::vector<std::uint32_t> offsets { 0 };
+};
+
+
+inline ash::fsst_symbol_table::fsst_symbol_table() noexcept {
+    std::fill(values, values + 256, 0);
+    std::fill(lengths, lengths + 256, 0);
+    index();
+}
+
+template <class Range>
+ash::fsst_symbol_table ash::fsst_symbol_table::build(const Range& sample) {
+    // Symbols 0...254 are codes of the table. 256...511 are the single bytes, which are
+    // escaped in the current table but are candidates for the next one.
+    constexpr std::size_t pseudo = 512;
+
+    fsst_symbol_table table;
+    std::vector<std::uint32_t> single(pseudo);
+    std::vector<std::uint32_t> pairs(pseudo * pseudo);
+
+    auto value_of = [&table](std::size_t sym) -> std::uint64_t {
+        if (sym < 256)
+            return table.values[sym];
+
+        unsigned char bytes[8] = { static_cast<unsigned char>(sym - 256) };
+        std::uint64_t value;
+        std::memcpy(&value, bytes, 8);
+        return value;
+    };
+    auto length_of = [&table](std::size_t sym) -> std::size_t {
+        return sym < 256 ? table.lengths[sym] : 1;
+    };
+
+    for (std::size_t round = 0; round < build_rounds; ++round) {
+        std::fill(single.begin(), single.end(), 0);
+        std::fill(pairs.begin(), pairs.end(), 0);
+
+        for (const auto& str : sample) {
+            const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(str.data());
+            std::size_t len = str.size();
+            std::size_t prev = pseudo;
+
+            for (std::size_t pos = 0; pos < len;) {
+                std::uint8_t code;
+                std::size_t matched = table.match(p + pos, len - pos, code);
+
+                std::size_t sym = matched ? code : 256 + p[pos];
+                pos += matched ? matched : 1;
+
+                ++single[sym];
+                if (prev != pseudo)
+                    ++pairs[prev * pseudo + sym];
+                prev = sym;
+            }
+        }
+
+        // Sum the gains of equal candidates (e.g. a pair that is also an existing symbol).
+        std::unordered_map<std::uint64_t, candidate> by_value[max_symbol_length + 1];
+
+        auto add = [&by_value](std::uint64_t value, std::size_t length, std::uint64_t gain) {
+            auto& c = by_value[length][value];
+            c.value = value;
+            c.length = static_cast<std::uint8_t>(length);
+            c.gain += gain;
+        };
+
+        for (std::size_t a = 0; a < pseudo; ++a) {
+            if (single[a] == 0)
+                continue;
+
+            add(value_of(a), length_of(a), std::uint64_t(single[a]) * length_of(a));
+
+            for (std::size_t b = 0; b < pseudo; ++b) {
+                std::uint32_t n = pairs[a * pseudo + b];
+                std::size_t la = length_of(a), lb = length_of(b);
+
+                if (n == 0 || la + lb > max_symbol_length)
+                    continue;
+
+                unsigned char bytes[16] = {};
+                std::uint64_t va = value_of(a), vb = value_of(b);
+                std::memcpy(bytes, &va, la);
+                std::memcpy(bytes + la, &vb, lb);
+
+                std::uint64_t value;
+                std::memcpy(&value, bytes, 8);
+                add(value, la + lb, std::uint64_t(n) * (la + lb));
+            }
+        }
+
+        std::vector<candidate> candidates;
+        for (auto& map : by_value)
+            for (auto& entry : map)
+                candidates.push_back(entry.second);
+
+        std::size_t keep = std::min(candidates.size(), max_symbols);
+        std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), [](const candidate& x, const candidate& y) {
+            if (x.gain != y.gain)
+                return x.gain > y.gain;
+            if (x.length != y.length)
+                return x.length > y.length;
+            return x.value < y.value;
+        });
+
+        table.count = keep;
+        for (std::size_t i = 0; i < keep; ++i) {
+            table.values[i] = candidates[i].value;
+            table.lengths[i] = candidates[i].length;
+        }
+        std::fill(table.values + keep, table.values + 256, 0);
+        std::fill(table.lengths + keep, table.lengths + 256, 0);
+
+        table.index();
+    }
+
+    return table;
+}
+
+inline std::size_t ash::fsst_symbol_table::size() const noexcept {
+    return count;
+}
+
+inline std::size_t ash::fsst_symbol_table::encode(const char* in, std::size_t len, std::uint8_t* out) const noexcept {
+    const std::uint8_t* p = reinterpret_cast<const std::uint8_t*>(in);
+    std::uint8_t* o = out;
+
+    for (std::size_t pos = 0; pos < len;) {
+        std::uint8_t code;
+        std::size_t matched = match(p + pos, len - pos, code);
+
+        if (matched) {
+            *o++ = code;
+            pos += matched;
+        }
+        else {
+            *o++ = escape;
+            *o++ = p[pos++];
+        }
+    }
+
+    return o - out;
+}
+
+inline std::size_t ash::fsst_symbol_table::decode_unchecked(const std::uint8_t* in, std::size_t len, char* out) const noexcept {
+    char* o = out;
+    std::size_t i = 0;
+
+    // Four codes at a time, as long as none of them is an escape.
+    while (i + 4 <= len) {
+        std::uint32_t four;
+        std::memcpy(&four, in + i, 4);
+
+        // Has a byte equal to 0xFF <=> `~four` has a zero byte.
+        std::uint32_t inverted = ~four;
+        if (((inverted - 0x01010101u) & ~inverted & 0x80808080u) != 0)
+            break;
+
+        for (std::size_t k = 0; k < 4; ++k) {
+            std::uint8_t code = in[i + k];
+            std::memcpy(o, &values[code], 8);
+            o += lengths[code];
+        }
+
+        i += 4;
+    }
+
+    while (i < len) {
+        std::uint8_t code = in[i++];
+
+        if (code != escape) {
+            std::memcpy(o, &values[code], 8);
+            o += lengths[code];
+        }
+        else {
+            *o++ = static_cast<char>(in[i++]);
+        }
+    }
+
+    return o - out;
+}
+
+inline std::size_t ash::fsst_symbol_table::decode(const std::uint8_t* in, std::size_t len, char* out, std::size_t capacity) const noexcept {
+    char* o = out;
+    char* end = out + capacity;
+    std::size_t i = 0;
+
+    // Fast path while a whole 8-byte store fits.
+    while (i < len && end - o >= static_cast<std::ptrdiff_t>(max_symbol_length)) {
+        std::uint8_t code = in[i++];
+
+        if (code != escape) {
+            std::memcpy(o, &values[code], 8);
+            o += lengths[code];
+        }
+        else {
+            *o++ = static_cast<char>(in[i++]);
+        }
+    }
+
+    while (i < len) {
+        std::uint8_t code = in[i++];
+        std::size_t length = (code != escape) ? lengths[code] : 1;
+
+        if (static_cast<std::size_t>(end - o) < length)
+            return capacity + 1;
+
+        if (code != escape)
+            std::memcpy(o, &values[code], length);
+        else
+            *o = static_cast<char>(in[i++]);
+
+        o += length;
+    }
+
+    return o - out;
+}
+
+inline std::string_view ash::fsst_symbol_table::symbol(std::uint8_t code) const noexcept {
+    return std::string_view(reinterpret_cast<const char*>(&values[code]), lengths[code]);
+}
+
+inline std::size_t ash::fsst_symbol_table::match(const std::uint8_t* p, std::size_t remaining, std::uint8_t& code) const noexcept {
+    std::uint64_t word = 0;
+    std::memcpy(&word, p, remaining < 8 ? remaining : 8);
+
+    for (std::size_t k = first_begin[p[0]]; k < first_begin[p[0] + 1]; ++k) {
+        std::uint8_t c = order[k];
+        std::size_t length = lengths[c];
+
+        if (length <= remaining && (word & mask(length)) == values[c]) {
+            code = c;
+            return length;
+        }
+    }
+
+    return 0;
+}
+
+inline void ash::fsst_symbol_table::index() {
+    std::uint8_t codes[256];
+    for (std::size_t i = 0; i < count; ++i)
+        codes[i] = static_cast<std::uint8_t>(i);
+
+    std::sort(codes, codes + count, [this](std::uint8_t a, std::uint8_t b) {
+        std::uint8_t fa = first_byte(values[a]), fb = first_byte(values[b]);
+        if (fa != fb)
+            return fa < fb;
+        return lengths[a] > lengths[b];
+    });
+
+    std::fill(first_begin, first_begin + 257, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        order[i] = codes[i];
+        ++first_begin[first_byte(values[codes[i]]) + 1];
+    }
+
+    for (std::size_t b = 0; b < 256; ++b)
+        first_begin[b + 1] += first_begin[b];
+}
+
+inline std::uint64_t ash::fsst_symbol_table::mask(std::size_t length) noexcept {
+    // Built through memory, so it selects the first `length` bytes on any endianness.
+    unsigned char bytes[8] = {};
+    std::memset(bytes, 0xFF, length);
+
+    std::uint64_t m;
+    std::memcpy(&m, bytes, 8);
+    return m;
+}
+
+inline std::uint8_t ash::fsst_symbol_table::first_byte(std::uint64_t value) noexcept {
+    unsigned char bytes[8];
+    std::memcpy(bytes, &value, 8);
+    return bytes[0];
+}
+
+template <std::size_t N>
+ash::fsst_column<N>::fsst_column(const fsst_symbol_table& symbols) : table(symbols) {}
+
+template <std::size_t N>
+template <class Range>
+ash::fsst_column<N> ash::fsst_column<N>::build(const Range& values, size_type sample_size) {
+    std::vector<std::string_view> all;
+    for (const auto& value : values)
+        all.emplace_back(value.data(), value.size());
+
+    std::vector<std::string_view> sample;
+    if (all.size() <= sample_size) {
+        sample = all;
+    }
+    else {
+        for (size_type i = 0; i < sample_size; ++i)
+            sample.push_back(all[i * all.size() / sample_size]);
+    }
+
+    fsst_column column(fsst_symbol_table::build(sample));
+    for (std::string_view value : all)
+        column.push_back(value);
+
+    return column;
+}
+
+template <std::size_t N>
+typename ash::fsst_column<N>::value_type ash::fsst_column<N>::operator[](size_type i) const {
+    value_type result;
+    result.resize_and_overwrite(N, [this, i](char* out, size_type capacity) {
+        return table.decode(bytes.data() + offsets[i], offsets[i + 1] - offsets[i], out, capacity);
+    });
+
+    return result;
+}
+
+template <std::size_t N>
+typename ash::fsst_column<N>::value_type ash::fsst_column<N>::at(size_type i) const {
+    ash::throw_if_outside_of_size(size(), i);
+    return (*this)[i];
+}
+
+template <std::size_t N>
+std::string_view ash::fsst_column<N>::decode(size_type i, char* buffer) const noexcept {
+    std::size_t len = table.decode_unchecked(bytes.data() + offsets[i], offsets[i + 1] - offsets[i], buffer);
+    return std::string_view(buffer, len);
+}
+
+template <std::size_t N>
+const ash::fsst_symbol_table& ash::fsst_column<N>::symbols() const noexcept {
+    return table;
+}
+
+template <std::size_t N>
+bool ash::fsst_column<N>::empty() const noexcept {
+    return offsets.size() == 1;
+}
+
+template <std::size_t N>
+typename ash::fsst_column<N>::size_type ash::fsst_column<N>::size() const noexcept {
+    return offsets.size() - 1;
+}
+
+template <std::size_t N>
+typename ash::fsst_column<N>::size_type ash::fsst_column<N>::compressed_bytes() const noexcept {
+    return bytes.size() + offsets.size() * sizeof(std::uint32_t);
+}
+
+template <std::size_t N>
+void ash::fsst_column<N>::push_back(std::string_view str) {
+    ash::throw_if_outside_of_capacity(N, str.size());
+
+    size_type old = bytes.size();
+    bytes.resize(old + fsst_symbol_table::max_encoded_size(str.size()));
+
+    size_type written = table.encode(str.data(), str.size(), bytes.data() + old);
+    bytes.resize(old + written);
+
+    ash::throw_if_outside_of_capacity<std::size_t>(UINT32_MAX, bytes.size());
+    offsets.push_back(static_cast<std::uint32_t>(bytes.size()));
+}
+
+template <std::size_t N>
+template <std::size_t M>
+void ash::fsst_column<N>::push_back(const static_string<M>& str) {
+    push_back(std::string_view(str.data(), str.size()));
+}
+
+template <std::size_t N>
+void ash::fsst_column<N>::reserve(size_type count, size_type compressed) {
+    offsets.reserve(count + 1);
+    bytes.reserve(compressed);
+}
+
+template <std::size_t N>
+void ash::fsst_column<N>::clear() noexcept {
+    bytes.clear();
+    offsets.assign(1, 0);
+}
+
+#endif // ASH_FSST
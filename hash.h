@@ -0,0 +1,134 @@
+/*
+================================================================================
+  ash/hash.h - A fast 64-bit hash of byte ranges.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::hash_bytes(data, len, seed)` hashes a range of bytes into 64 bits
+    with the hash function of wyhash. The input is read 8 or 16 bytes at a
+    time and mixed with 64x64->128 bit multiplications, so short strings
+    (the usual keys) take only a few instructions.
+
+    `std::hash` of `ash::basic_static_string` and the intern pool are built
+    on it.
+
+  Usage:
+    #include "ash/hash.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_HASH
+
+================================================================================
+*/
+
+#ifndef ASH_HASH
+#define ASH_HASH
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ash {
+    /// @brief Hashes the bytes in [`data`, `data + len`) into a 64-bit value.
+    /// @param data Pointer to the first byte. Can be `nullptr` if `len` is `0`.
+    /// @param len Number of bytes.
+    /// @param seed Any value. Different seeds give unrelated hashes.
+    /// @return The hash.
+    /// @note This is the hash function of wyhash (public domain, by Wang Yi). It reads the input
+    /// 8 or 16 bytes at a time and needs a 64x64->128 bit multiplication, which is one
+    /// instruction on all 64-bit targets.
+    /// @note The result is the same on all platforms with the same endianness, but it's not
+    /// a cryptographic hash.
+    inline std::uint64_t hash_bytes(const void* data, std::size_t len, std::uint64_t seed = 0) noexcept;
+
+    namespace __hash_details {
+        constexpr std::uint64_t secret[4] = {
+            0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+        };
+
+        inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+            __uint128_t r = static_cast<__uint128_t>(a) * b;
+            return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+        }
+
+        inline std::uint64_t read8(const unsigned char* p) noexcept {
+            std::uint64_t v;
+            std::memcpy(&v, p, 8);
+            return v;
+        }
+
+        inline std::uint64_t read4(const unsigned char* p) noexcept {
+            std::uint32_t v;
+            std::memcpy(&v, p, 4);
+            return v;
+        }
+
+        /// @brief Reads 1 to 3 bytes.
+        inline std::uint64_t read3(const unsigned char* p, std::size_t len) noexcept {
+            return (static_cast<std::uint64_t>(p[0]) << 16) | (static_cast<std::uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+        }
+    } // namespace __hash_details
+}
+
+inline std::uint64_t ash::hash_bytes(const void* data, std::size_t len, std::uint64_t seed) noexcept {
+    using namespace __hash_details;
+
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    seed ^= mix(seed ^ secret[0], secret[1]);
+
+    std::uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0) {
+            a = read3(p, len);
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        std::size_t i = len;
+
+        if (i > 48) {
+            std::uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                see1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ see1);
+                see2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16) {
+            seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<std::uint64_t>(r);
+    b = static_cast<std::uint64_t>(r >> 64);
+
+    return mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+#endif // ASH_HASH
@@ -0,0 +1,249 @@
+/*
+================================================================================
+  ash/hex.h - Hexadecimal encoding and decoding into `ash::static_string`s.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    - `ash::hex_encode(bytes)` returns a `static_string<2 * N>` for `N` input
+      bytes (a `basic_static_string` of 1-byte characters, or a `std::array`
+      of bytes such as a digest).
+    - `ash::hex_decode(str)` returns a `static_string<N / 2>` of the bytes,
+      and accepts both cases. Invalid input throws `std::invalid_argument`.
+
+    Both are constexpr. At runtime, 16 bytes are encoded (or 32 digits
+    decoded) at a time with SSE2: the nibbles are turned into digits with
+    one compare and one add, and interleaved with an unpack.
+
+  Usage:
+    #include "ash/hex.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_HEX
+
+================================================================================
+*/
+
+#ifndef ASH_HEX
+#define ASH_HEX
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include "../ash/simd.h"
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @brief Writes the `2 * size` hexadecimal digits of [`in`, `in + size`) to `out`.
+    /// @tparam Byte A type of 1 byte (`char`, `unsigned char`, `std::byte`, ...).
+    template <class Byte>
+    constexpr void hex_encode(const Byte* in, std::size_t size, char* out, bool uppercase = false) noexcept;
+
+    /// @brief Writes the `size / 2` bytes of the hexadecimal digits [`in`, `in + size`) to `out`.
+    /// @return `false` if `size` is odd or a character isn't a hexadecimal digit.
+    template <class Byte>
+    constexpr bool hex_decode(const char* in, std::size_t size, Byte* out) noexcept;
+
+    template <class CharT, std::size_t N>
+    constexpr static_string<2 * N> hex_encode(const basic_static_string<CharT, N>& bytes, bool uppercase = false) noexcept;
+
+    template <class T, std::size_t N>
+    constexpr static_string<2 * N> hex_encode(const std::array<T, N>& bytes, bool uppercase = false) noexcept;
+
+    /// @exception `std::invalid_argument` if the size is odd or a character isn't a hexadecimal digit.
+    template <std::size_t N>
+    constexpr static_string<N / 2> hex_decode(const static_string<N>& str);
+
+    /// @brief Decodes `str` into a string of capacity `N`.
+    /// @exception `std::invalid_argument` if the size is odd or a character isn't a hexadecimal digit.
+    /// @exception `std::out_of_range` if the result is longer than `N`.
+    template <std::size_t N>
+    constexpr static_string<N> hex_decode(std::string_view str);
+
+    namespace __hex_details {
+        /// @brief The value of a hexadecimal digit, or `-1`.
+        constexpr int digit_value(char c) noexcept {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+
+            return -1;
+        }
+
+        /// @brief Encodes the multiples of 16 bytes and returns how many bytes were encoded.
+        std::size_t encode_simd(const unsigned char* in, std::size_t size, char* out, bool uppercase) noexcept;
+
+        /// @brief Decodes the multiples of 32 digits and returns how many digits were decoded,
+        /// or `std::size_t(-1)` if there is an invalid digit.
+        std::size_t decode_simd(const char* in, std::size_t size, unsigned char* out) noexcept;
+    }
+}
+
+#ifdef ASH_SIMD_SSE2
+
+inline std::size_t ash::__hex_details::encode_simd(const unsigned char* in, std::size_t size, char* out, bool uppercase) noexcept {
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i letter = _mm_set1_epi8(uppercase ? 'A' - '0' - 10 : 'a' - '0' - 10);
+
+    auto digits = [&](__m128i nibbles) {
+        return _mm_add_epi8(_mm_add_epi8(nibbles, zero), _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letter));
+    };
+
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i high = digits(_mm_and_si128(_mm_srli_epi16(v, 4), low_mask));
+        __m128i low = digits(_mm_and_si128(v, low_mask));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+    }
+
+    return i;
+}
+
+inline std::size_t ash::__hex_details::decode_simd(const char* in, std::size_t size, unsigned char* out) noexcept {
+    auto values = [](__m128i c, __m128i& valid) {
+        // Both ranges are checked with unsigned `min`: `x <= max` exactly when `min(x, max) == x`.
+        __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+        __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+        __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+        valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_letter));
+
+        return _mm_or_si128(_mm_and_si128(digit, is_digit),
+                            _mm_and_si128(_mm_add_epi8(letter, _mm_set1_epi8(10)), is_letter));
+    };
+
+    // The first digit of a pair is the low byte of a 16-bit lane, and the high nibble of the result.
+    auto combine = [](__m128i v) {
+        return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(v, 8));
+    };
+
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m128i valid = _mm_set1_epi8(-1);
+        __m128i a = values(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), valid);
+        __m128i b = values(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16)), valid);
+
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+            return std::size_t(-1);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 2), _mm_packus_epi16(combine(a), combine(b)));
+    }
+
+    return i;
+}
+
+#endif // ASH_SIMD_SSE2
+
+template <class Byte>
+constexpr void ash::hex_encode(const Byte* in, std::size_t size, char* out, bool uppercase) noexcept {
+    static_assert(sizeof(Byte) == 1, "ash::hex_encode: The input must be bytes.");
+
+    std::size_t i = 0;
+
+#ifdef ASH_SIMD_SSE2
+    if (!__builtin_is_constant_evaluated())
+        i = __hex_details::encode_simd(reinterpret_cast<const unsigned char*>(in), size, out, uppercase);
+#endif
+
+    const char* alphabet = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+
+    for (; i < size; ++i) {
+        auto byte = static_cast<unsigned char>(in[i]);
+        out[2 * i] = alphabet[byte >> 4];
+        out[2 * i + 1] = alphabet[byte & 0x0F];
+    }
+}
+
+template <class Byte>
+constexpr bool ash::hex_decode(const char* in, std::size_t size, Byte* out) noexcept {
+    static_assert(sizeof(Byte) == 1, "ash::hex_decode: The output must be bytes.");
+
+    if (size % 2 != 0)
+        return false;
+
+    std::size_t i = 0;
+
+#ifdef ASH_SIMD_SSE2
+    if (!__builtin_is_constant_evaluated()) {
+        i = __hex_details::decode_simd(in, size, reinterpret_cast<unsigned char*>(out));
+        if (i == std::size_t(-1))
+            return false;
+    }
+#endif
+
+    for (; i < size; i += 2) {
+        int high = __hex_details::digit_value(in[i]);
+        int low = __hex_details::digit_value(in[i + 1]);
+
+        if (high < 0 || low < 0)
+            return false;
+
+        out[i / 2] = static_cast<Byte>((high << 4) | low);
+    }
+
+    return true;
+}
+
+template <class CharT, std::size_t N>
+constexpr ash::static_string<2 * N> ash::hex_encode(const basic_static_string<CharT, N>& bytes, bool uppercase) noexcept {
+    static_string<2 * N> result;
+    result.resize_and_overwrite(2 * bytes.size(), [&bytes, uppercase](char* out, std::size_t count) {
+        ash::hex_encode(bytes.data(), bytes.size(), out, uppercase);
+        return count;
+    });
+
+    return result;
+}
+
+template <class T, std::size_t N>
+constexpr ash::static_string<2 * N> ash::hex_encode(const std::array<T, N>& bytes, bool uppercase) noexcept {
+    static_string<2 * N> result;
+    result.resize_and_overwrite(2 * N, [&bytes, uppercase](char* out, std::size_t count) {
+        ash::hex_encode(bytes.data(), N, out, uppercase);
+        return count;
+    });
+
+    return result;
+}
+
+template <std::size_t N>
+constexpr ash::static_string<N / 2> ash::hex_decode(const static_string<N>& str) {
+    return ash::hex_decode<N / 2>(std::string_view(str.data(), str.size()));
+}
+
+template <std::size_t N>
+constexpr ash::static_string<N> ash::hex_decode(std::string_view str) {
+    ash::throw_if_outside_of_capacity(N, str.size() / 2);
+
+    static_string<N> result;
+
+    bool valid = true;
+    result.resize_and_overwrite(str.size() / 2, [&str, &valid](char* out, std::size_t count) {
+        valid = ash::hex_decode(str.data(), str.size(), out);
+        return valid ? count : 0;
+    });
+
+    if (!valid)
+        throw std::invalid_argument("ash::hex_decode: The input is not a hexadecimal string.");
+
+    return result;
+}
+
+#endif // ASH_HEX
@@ -0,0 +1,384 @@
+/*
+================================================================================
+  ash/intern_pool.h - Concurrent interning of `ash::basic_static_string`s into 32-bit ids.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::basic_intern_pool<CharT, N>` gives every distinct string a stable
+    32-bit id. Comparing or hashing two interned strings is then just an
+    integer operation.
+
+    - The hash table is split into shards. Looking a string up never takes a
+      lock: every slot is a single atomic word (a tag from the hash and the
+      id), and the table of a shard is replaced as a whole when it grows.
+      Only inserting a new string locks its shard.
+    - The strings are stored in segments which never move, so `pool[id]` is
+      lock-free as well and the references stay valid for the lifetime of
+      the pool.
+
+    Ids are handed out densely from `0`, in the order the strings were first
+    inserted. `size()` only counts the strings which are completely written,
+    so every id below it can be read while others are being inserted.
+
+  Usage:
+    #include "ash/intern_pool.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_INTERN_POOL
+
+================================================================================
+*/
+
+#ifndef ASH_INTERN_POOL
+#define ASH_INTERN_POOL
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "../ash/hash.h"
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @class basic_intern_pool
+    /// @brief Thread-safe mapping from distinct strings to dense 32-bit ids and back.
+    /// @tparam CharT Character type.
+    /// @tparam N Capacity of the strings.
+    template <class CharT, std::size_t N>
+    class basic_intern_pool;
+
+    template <std::size_t N>
+    using intern_pool = basic_intern_pool<char, N>;
+}
+
+template <class CharT, std::size_t N>
+class ash::basic_intern_pool {
+public:
+    using value_type = basic_static_string<CharT, N>;
+    using sv_type = std::basic_string_view<CharT>;
+    using id_type = std::uint32_t;
+    using size_type = std::size_t;
+
+    /// @brief Returned by `find` if the string isn't in the pool.
+    static constexpr id_type npos = UINT32_MAX;
+
+    /// @brief The number of shards of the hash table. Inserts into different shards don't contend.
+    static constexpr size_type shards = 64;
+
+private:
+    /// @brief The strings with ids [`0`, `first_segment`) are in segment `0`, and every other
+    /// segment is as large as all the previous ones together.
+    static constexpr size_type first_segment_bits = 10;
+    static constexpr size_type first_segment = size_type(1) << first_segment_bits;
+    static constexpr size_type segments = 33 - first_segment_bits;
+
+    /// @brief Open addressing with linear probing. `0` is an empty slot, everything else is
+    /// `(tag << 32) | (id + 1)`.
+    struct table {
+        explicit table(size_type capacity);
+
+        size_type mask;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+        size_type used = 0;
+    };
+
+    struct alignas(64) shard {
+        std::atomic<const table*> current { nullptr };
+        std::mutex mutex;
+
+        /// @brief The current table and every table it replaced. Readers may still be probing the
+        /// old ones, so they are only freed with the pool.
+        std::vector<std::unique_ptr<table>> tables;
+    };
+
+public:
+
+// Constructors
+
+    basic_intern_pool();
+
+    basic_intern_pool(const basic_intern_pool&) = delete;
+    basic_intern_pool& operator=(const basic_intern_pool&) = delete;
+
+    ~basic_intern_pool();
+
+// Element access
+
+    /// @brief The string with id `id`. No bounds checking is performed. Lock-free.
+    /// @note The reference stays valid as long as the pool does.
+    const value_type& operator[](id_type id) const noexcept;
+
+    /// @brief The string with id `id`.
+    /// @exception `std::out_of_range` if `id` is equal or more than `size()`.
+    const value_type& at(id_type id) const;
+
+// Capacity
+
+    /// @brief The number of strings stored so far. All the ids below it can be read, even while
+    /// other threads are inserting.
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+
+// Operations
+
+    /// @brief The id of `str`, inserting it if it's new. Thread-safe.
+    /// @exception `std::length_error` if all the ids are taken.
+    id_type intern(const value_type& str);
+
+    /// @brief The id of `str`, inserting it if it's new. Thread-safe.
+    /// @exception `std::out_of_range` if `str.size()` is more than `N`.
+    /// @exception `std::length_error` if all the ids are taken.
+    id_type intern(sv_type str);
+
+    /// @brief The id of `str`, or `npos` if it isn't in the pool. Lock-free.
+    id_type find(const value_type& str) const noexcept;
+
+    /// @brief The id of `str`, or `npos` if it isn't in the pool. Lock-free.
+    id_type find(sv_type str) const noexcept;
+
+private:
+    static std::uint64_t hash_of(sv_type str) noexcept;
+    static size_type segment_of(id_type id) noexcept;
+    static size_type segment_begin(size_type segment) noexcept;
+    static size_type segment_size(size_type segment) noexcept;
+
+    /// @brief Probes `t` for `str`. Returns the id or `npos`.
+    id_type lookup(const table* t, sv_type str, std::uint64_t hash) const noexcept;
+
+    /// @brief Stores `str` under a new id. Only called with the shard locked.
+    id_type store(sv_type str);
+
+    /// @brief Replaces the table of `s` with one twice as large. Only called with the shard locked.
+    void grow(shard& s);
+
+    static void place(const table& t, std::uint64_t slot, std::uint64_t hash) noexcept;
+
+    shard sharded[shards];
+    std::atomic<value_type*> strings[segments] {};
+    std::atomic<size_type> next_id { 0 };
+
+    /// @brief The ids below it are completely written. It follows `next_id`, in order.
+    std::atomic<size_type> published { 0 };
+};
+
+#define ASH_bip_template template <class CharT, std::size_t N>
+#define ASH_bip_name ash::basic_intern_pool<CharT, N>
+
+ASH_bip_template
+ASH_bip_name::table::table(size_type capacity)
+    : mask(capacity - 1), slots(new std::atomic<std::uint64_t>[capacity]) {
+    for (size_type i = 0; i < capacity; ++i)
+        slots[i].store(0, std::memory_order_relaxed);
+}
+
+ASH_bip_template
+ASH_bip_name::basic_intern_pool() {
+    for (shard& s : sharded) {
+        s.tables.emplace_back(new table(16));
+        s.current.store(s.tables.back().get(), std::memory_order_release);
+    }
+}
+
+ASH_bip_template
+ASH_bip_name::~basic_intern_pool() {
+    for (auto& segment : strings)
+        delete[] segment.load(std::memory_order_relaxed);
+}
+
+ASH_bip_template
+const typename ASH_bip_name::value_type& ASH_bip_name::operator[](id_type id) const noexcept {
+    size_type segment = segment_of(id);
+    return strings[segment].load(std::memory_order_acquire)[id - segment_begin(segment)];
+}
+
+ASH_bip_template
+const typename ASH_bip_name::value_type& ASH_bip_name::at(id_type id) const {
+    ash::throw_if_outside_of_size<size_type>(size(), id);
+    return (*this)[id];
+}
+
+ASH_bip_template
+typename ASH_bip_name::size_type ASH_bip_name::size() const noexcept {
+    return published.load(std::memory_order_acquire);
+}
+
+ASH_bip_template
+bool ASH_bip_name::empty() const noexcept {
+    return size() == 0;
+}
+
+ASH_bip_template
+typename ASH_bip_name::id_type ASH_bip_name::intern(const value_type& str) {
+    return intern(sv_type(str.data(), str.size()));
+}
+
+ASH_bip_template
+typename ASH_bip_name::id_type ASH_bip_name::intern(sv_type str) {
+    ash::throw_if_outside_of_capacity(N, str.size());
+
+    std::uint64_t hash = hash_of(str);
+    shard& s = sharded[hash % shards];
+
+    id_type id = lookup(s.current.load(std::memory_order_acquire), str, hash);
+    if (id != npos)
+        return id;
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    // Another thread may have inserted it since.
+    const table* t = s.current.load(std::memory_order_relaxed);
+    id = lookup(t, str, hash);
+    if (id != npos)
+        return id;
+
+    if ((t->used + 1) * 2 > t->mask + 1) {
+        grow(s);
+        t = s.current.load(std::memory_order_relaxed);
+    }
+
+    id = store(str);
+    place(*t, ((hash >> 32) << 32) | (std::uint64_t(id) + 1), hash);
+    ++s.tables.back()->used;
+
+    return id;
+}
+
+ASH_bip_template
+typename ASH_bip_name::id_type ASH_bip_name::find(const value_type& str) const noexcept {
+    return find(sv_type(str.data(), str.size()));
+}
+
+ASH_bip_template
+typename ASH_bip_name::id_type ASH_bip_name::find(sv_type str) const noexcept {
+    if (str.size() > N)
+        return npos;
+
+    std::uint64_t hash = hash_of(str);
+    return lookup(sharded[hash % shards].current.load(std::memory_order_acquire), str, hash);
+}
+
+ASH_bip_template
+std::uint64_t ASH_bip_name::hash_of(sv_type str) noexcept {
+    return ash::hash_bytes(str.data(), str.size() * sizeof(CharT));
+}
+
+ASH_bip_template
+typename ASH_bip_name::size_type ASH_bip_name::segment_of(id_type id) noexcept {
+    std::uint64_t index = std::uint64_t(id) + first_segment;
+    return (63 - __builtin_clzll(index)) - first_segment_bits;
+}
+
+ASH_bip_template
+typename ASH_bip_name::size_type ASH_bip_name::segment_begin(size_type segment) noexcept {
+    return (size_type(1) << (segment + first_segment_bits)) - first_segment;
+}
+
+ASH_bip_template
+typename ASH_bip_name::size_type ASH_bip_name::segment_size(size_type segment) noexcept {
+    return size_type(1) << (segment + first_segment_bits);
+}
+
+ASH_bip_template
+typename ASH_bip_name::id_type ASH_bip_name::lookup(const table* t, sv_type str, std::uint64_t hash) const noexcept {
+    std::uint64_t tag = hash >> 32;
+
+    // The low bits picked the shard, so the position starts from the middle ones.
+    for (size_type i = (hash >> 8) & t->mask;; i = (i + 1) & t->mask) {
+        std::uint64_t slot = t->slots[i].load(std::memory_order_acquire);
+
+        if (slot == 0)
+            return npos;
+
+        if ((slot >> 32) == tag) {
+            id_type id = static_cast<id_type>((slot & UINT32_MAX) - 1);
+            const value_type& candidate = (*this)[id];
+
+            if (sv_type(candidate.data(), candidate.size()) == str)
+                return id;
+        }
+    }
+}
+
+ASH_bip_template
+typename ASH_bip_name::id_type ASH_bip_name::store(sv_type str) {
+    size_type id = next_id.load(std::memory_order_relaxed);
+
+    // Ids are taken with a CAS (not `fetch_add`), so a failed insert doesn't leave a hole.
+    for (;;) {
+        if (id >= npos)
+            throw std::length_error("The intern pool is out of ids.");
+
+        size_type segment = segment_of(static_cast<id_type>(id));
+        if (strings[segment].load(std::memory_order_acquire) == nullptr) {
+            value_type* fresh = new value_type[segment_size(segment)];
+            value_type* expected = nullptr;
+
+            if (!strings[segment].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+                delete[] fresh;
+        }
+
+        // The id is only visible to others after it is placed in a table or counted by `size()`,
+        // which both happen after the string is written.
+        if (next_id.compare_exchange_weak(id, id + 1, std::memory_order_acq_rel))
+            break;
+    }
+
+    size_type segment = segment_of(static_cast<id_type>(id));
+    value_type& target = strings[segment].load(std::memory_order_acquire)[id - segment_begin(segment)];
+    target.resize_and_overwrite(str.size(), [&str](CharT* out, size_type) {
+        str.copy(out, str.size());
+        return str.size();
+    });
+
+    // The ids below are taken by other threads which may still be writing. Each of them only waits
+    // for the ones before it, so this ends as soon as they are written.
+    while (published.load(std::memory_order_acquire) != id)
+        std::this_thread::yield();
+
+    published.store(id + 1, std::memory_order_release);
+
+    return static_cast<id_type>(id);
+}
+
+ASH_bip_template
+void ASH_bip_name::grow(shard& s) {
+    const table& old = *s.tables.back();
+    std::unique_ptr<table> bigger(new table((old.mask + 1) * 2));
+
+    for (size_type i = 0; i <= old.mask; ++i) {
+        std::uint64_t slot = old.slots[i].load(std::memory_order_relaxed);
+        if (slot == 0)
+            continue;
+
+        const value_type& str = (*this)[static_cast<id_type>((slot & UINT32_MAX) - 1)];
+        place(*bigger, slot, hash_of(sv_type(str.data(), str.size())));
+    }
+
+    bigger->used = old.used;
+    s.tables.push_back(std::move(bigger));
+    s.current.store(s.tables.back().get(), std::memory_order_release);
+}
+
+ASH_bip_template
+void ASH_bip_name::place(const table& t, std::uint64_t slot, std::uint64_t hash) noexcept {
+    size_type i = (hash >> 8) & t.mask;
+    while (t.slots[i].load(std::memory_order_relaxed) != 0)
+        i = (i + 1) & t.mask;
+
+    t.slots[i].store(slot, std::memory_order_release);
+}
+
+#undef ASH_bip_template
+#undef ASH_bip_name
+
+#endif // ASH_INTERN_POOL
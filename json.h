@@ -0,0 +1,307 @@
+/*
+================================================================================
+  ash/json.h - Escaping and unescaping of JSON strings into `ash::static_string`s.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    - `ash::json_escape(str, out)` writes the JSON escaped form of `str`
+      (without the surrounding quotes) into `out`.
+    - `ash::json_unescape(str, out)` does the opposite. `\uXXXX` escapes
+      (including surrogate pairs) become UTF-8.
+
+    Neither throws. They return a `json_status`: on `overflow`, `out` has the
+    longest prefix that fits (never a partial escape sequence or UTF-8
+    character). A `static_string<6 * N>` always fits the escaped form of `N`
+    characters.
+
+    The characters that need attention ('"', '\\' and the control characters
+    below 0x20) are found 16 at a time with SSE2 (three compares and one
+    movemask), and the runs between them are copied in bulk. A string which
+    needs no escaping is just copied.
+
+  Usage:
+    #include "ash/json.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_JSON
+
+================================================================================
+*/
+
+#ifndef ASH_JSON
+#define ASH_JSON
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "../ash/simd.h"
+#include "../ash/static_string.h"
+#include "../ash/utf.h"
+
+namespace ash {
+    /// @brief The result of `json_escape` and `json_unescape`.
+    enum class json_status {
+        ok,
+
+        /// @brief The output is too small. It has the longest prefix that fits, without splitting an
+        /// escape sequence or a UTF-8 character.
+        overflow,
+
+        /// @brief `json_unescape` only: a malformed escape sequence, a lone surrogate, or an
+        /// unescaped '"' or control character. The output has what was unescaped before it.
+        invalid
+    };
+
+    /// @brief Writes the escaped form of `str` into `out`, replacing its content.
+    template <std::size_t N>
+    json_status json_escape(std::string_view str, static_string<N>& out) noexcept;
+
+    /// @brief Writes the unescaped form of `str` into `out`, replacing its content.
+    template <std::size_t N>
+    json_status json_unescape(std::string_view str, static_string<N>& out) noexcept;
+
+    namespace __json_details {
+        /// @brief The position of the first character at or after `i` which is '"', '\\' or below
+        /// 0x20, or `size` if there is none.
+        std::size_t find_special(const char* in, std::size_t size, std::size_t i) noexcept;
+
+        inline bool is_special(char c) noexcept {
+            return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+        }
+
+        /// @brief The escape sequence of a special character.
+        /// @return Its size, 2 or 6.
+        std::size_t escape(char c, char* out) noexcept;
+
+        /// @brief Copies the first `count` characters of `in` (which has more of them), without
+        /// splitting a UTF-8 character. Returns the number of characters copied.
+        std::size_t copy_prefix(const char* in, std::size_t count, char* out) noexcept;
+
+        std::size_t escape(const char* in, std::size_t size, char* out, std::size_t capacity, json_status& status) noexcept;
+
+        std::size_t unescape(const char* in, std::size_t size, char* out, std::size_t capacity, json_status& status) noexcept;
+    }
+}
+
+inline std::size_t ash::__json_details::find_special(const char* in, std::size_t size, std::size_t i) noexcept {
+#ifdef ASH_SIMD_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i last_control = _mm_set1_epi8(0x1F);
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+        // `v <= 0x1F` (unsigned) exactly when `min(v, 0x1F) == v`.
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(v, last_control), v));
+
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask != 0)
+            return i + ash::simd::ctz(mask);
+    }
+#endif
+
+    for (; i < size; ++i)
+        if (is_special(in[i]))
+            return i;
+
+    return size;
+}
+
+inline std::size_t ash::__json_details::escape(char c, char* out) noexcept {
+    out[0] = '\\';
+
+    switch (c) {
+        case '"': out[1] = '"'; return 2;
+        case '\\': out[1] = '\\'; return 2;
+        case '\b': out[1] = 'b'; return 2;
+        case '\f': out[1] = 'f'; return 2;
+        case '\n': out[1] = 'n'; return 2;
+        case '\r': out[1] = 'r'; return 2;
+        case '\t': out[1] = 't'; return 2;
+        default: break;
+    }
+
+    static constexpr char digits[] = "0123456789abcdef";
+
+    out[1] = 'u';
+    out[2] = '0';
+    out[3] = '0';
+    out[4] = digits[static_cast<unsigned char>(c) >> 4];
+    out[5] = digits[static_cast<unsigned char>(c) & 0x0F];
+    return 6;
+}
+
+inline std::size_t ash::__json_details::copy_prefix(const char* in, std::size_t count, char* out) noexcept {
+    while (count != 0 && (static_cast<unsigned char>(in[count]) & 0xC0) == 0x80)
+        --count;
+
+    std::memcpy(out, in, count);
+    return count;
+}
+
+inline std::size_t ash::__json_details::escape(const char* in, std::size_t size, char* out, std::size_t capacity, json_status& status) noexcept {
+    std::size_t written = 0;
+    std::size_t i = 0;
+
+    for (;;) {
+        std::size_t special = find_special(in, size, i);
+
+        // The clean run before it.
+        std::size_t run = special - i;
+        if (run > capacity - written) {
+            status = json_status::overflow;
+            return written + copy_prefix(in + i, capacity - written, out + written);
+        }
+
+        std::memcpy(out + written, in + i, run);
+        written += run;
+
+        if (special == size) {
+            status = json_status::ok;
+            return written;
+        }
+
+        char sequence[6];
+        std::size_t length = escape(in[special], sequence);
+
+        if (length > capacity - written) {
+            status = json_status::overflow;
+            return written;
+        }
+
+        std::memcpy(out + written, sequence, length);
+        written += length;
+        i = special + 1;
+    }
+}
+
+inline std::size_t ash::__json_details::unescape(const char* in, std::size_t size, char* out, std::size_t capacity, json_status& status) noexcept {
+    auto hex4 = [in](std::size_t at) -> std::int32_t {
+        std::int32_t value = 0;
+        for (std::size_t k = 0; k < 4; ++k) {
+            char c = in[at + k];
+            int digit = (c >= '0' && c <= '9') ? c - '0'
+                      : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                      : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+
+            if (digit < 0)
+                return -1;
+
+            value = (value << 4) | digit;
+        }
+
+        return value;
+    };
+
+    std::size_t written = 0;
+    std::size_t i = 0;
+
+    for (;;) {
+        std::size_t special = find_special(in, size, i);
+
+        std::size_t run = special - i;
+        if (run > capacity - written) {
+            status = json_status::overflow;
+            return written + copy_prefix(in + i, capacity - written, out + written);
+        }
+
+        std::memcpy(out + written, in + i, run);
+        written += run;
+
+        if (special == size) {
+            status = json_status::ok;
+            return written;
+        }
+
+        // Only escape sequences are allowed here, not raw quotes or control characters.
+        if (in[special] != '\\' || special + 1 == size) {
+            status = json_status::invalid;
+            return written;
+        }
+
+        char decoded[4];
+        std::size_t length = 1;
+        std::size_t consumed = 2;
+
+        switch (in[special + 1]) {
+            case '"': decoded[0] = '"'; break;
+            case '\\': decoded[0] = '\\'; break;
+            case '/': decoded[0] = '/'; break;
+            case 'b': decoded[0] = '\b'; break;
+            case 'f': decoded[0] = '\f'; break;
+            case 'n': decoded[0] = '\n'; break;
+            case 'r': decoded[0] = '\r'; break;
+            case 't': decoded[0] = '\t'; break;
+
+            case 'u': {
+                std::int32_t cp = (size - special >= 6) ? hex4(special + 2) : -1;
+                consumed = 6;
+
+                // A high surrogate must be followed by an escaped low surrogate.
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    std::int32_t low = (size - special >= 12 && in[special + 6] == '\\' && in[special + 7] == 'u')
+                        ? hex4(special + 8) : -1;
+
+                    cp = (low >= 0xDC00 && low <= 0xDFFF) ? 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00) : -1;
+                    consumed = 12;
+                }
+                else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    cp = -1;
+                }
+
+                if (cp < 0) {
+                    status = json_status::invalid;
+                    return written;
+                }
+
+                length = __utf_details::encode(static_cast<char32_t>(cp), decoded);
+                break;
+            }
+
+            default:
+                status = json_status::invalid;
+                return written;
+        }
+
+        if (length > capacity - written) {
+            status = json_status::overflow;
+            return written;
+        }
+
+        std::memcpy(out + written, decoded, length);
+        written += length;
+        i = special + consumed;
+    }
+}
+
+template <std::size_t N>
+ash::json_status ash::json_escape(std::string_view str, static_string<N>& out) noexcept {
+    json_status status = json_status::ok;
+
+    out.resize_and_overwrite(N, [&str, &status](char* chars, std::size_t capacity) {
+        return __json_details::escape(str.data(), str.size(), chars, capacity, status);
+    });
+
+    return status;
+}
+
+template <std::size_t N>
+ash::json_status ash::json_unescape(std::string_view str, static_string<N>& out) noexcept {
+    json_status status = json_status::ok;
+
+    out.resize_and_overwrite(N, [&str, &status](char* chars, std::size_t capacity) {
+        return __json_details::unescape(str.data(), str.size(), chars, capacity, status);
+    });
+
+    return status;
+}
+
+#endif // ASH_JSON
@@ -0,0 +1,432 @@
+/*
+================================================================================
+  ash/line_reader.h - Reads lines from a file descriptor into `ash::static_string`s.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::line_reader<N>` reads a file descriptor in large chunks and yields
+    every line (without the '\n') as a `std::string_view` into its own
+    buffer, or copied into a `static_string<N>`. Nothing is allocated after
+    construction.
+
+    - There are two buffers. While the lines of one are consumed, the other
+      one is filled; the unfinished line at the end of a chunk is moved to
+      the front of the next one.
+    - Newlines are found 64 bytes at a time: one vectorized compare gives a
+      bit mask of the newlines in the block, and every line after that is
+      just a count of trailing zeros.
+    - With `prefetch`, a background thread does the `read` calls, so the
+      disk and the parsing overlap.
+
+    Lines longer than `N` are truncated, skipped, or reported with an
+    exception, according to `long_line_policy`.
+
+  Usage:
+    #include "ash/line_reader.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_LINE_READER
+
+================================================================================
+*/
+
+#ifndef ASH_LINE_READER
+#define ASH_LINE_READER
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include "../ash/simd.h"
+#include "../ash/static_string.h"
+
+namespace ash {
+    /// @brief What `line_reader` does with lines longer than its capacity.
+    enum class long_line_policy {
+        /// @brief Yields the first `N` characters and drops the rest.
+        truncate,
+
+        /// @brief Drops the whole line.
+        skip,
+
+        /// @brief Throws `std::length_error`.
+        error
+    };
+
+    /// @brief The options of `line_reader`.
+    struct line_reader_options {
+        long_line_policy long_lines = long_line_policy::truncate;
+
+        /// @brief The number of bytes asked from every `read` call.
+        std::size_t chunk_size = std::size_t(1) << 20;
+
+        /// @brief If `true`, a background thread reads the next chunk while the current one is parsed.
+        bool prefetch = false;
+    };
+
+    /// @class line_reader
+    /// @brief Reads lines of at most `N` characters from a file descriptor.
+    /// @tparam N The maximum length of a line.
+    template <std::size_t N>
+    class line_reader;
+}
+
+template <std::size_t N>
+class ash::line_reader {
+public:
+    using value_type = static_string<N>;
+    using size_type = std::size_t;
+
+// Constructors
+
+    /// @brief Reads from `fd`, which stays open and owned by the caller.
+    explicit line_reader(int fd, const line_reader_options& options = {});
+
+    line_reader(const line_reader&) = delete;
+    line_reader& operator=(const line_reader&) = delete;
+
+    /// @brief Stops the prefetch thread. Waits for a `read` in progress.
+    ~line_reader();
+
+// Operations
+
+    /// @brief Reads the next line.
+    /// @param line Receives the line. It stays valid until the next call.
+    /// @return `false` at the end of the input.
+    /// @exception `std::system_error` if `read` fails.
+    /// @exception `std::length_error` if a line is too long and the policy is `error`.
+    bool next(std::string_view& line);
+
+    /// @brief Reads the next line into `line`.
+    /// @return `false` at the end of the input.
+    bool next(value_type& line);
+
+    /// @brief The number of lines yielded so far.
+    size_type lines() const noexcept;
+
+private:
+    /// @brief The part of a buffer before the chunk, which receives the unfinished line of the
+    /// previous chunk. An unfinished line never needs more than `N` characters.
+    static constexpr size_type headroom = N;
+
+    /// @brief The scanner reads whole 64-byte blocks.
+    static constexpr size_type padding = 64;
+
+    struct buffer {
+        std::unique_ptr<char[]> data;
+        size_type size = 0;
+        bool ready = false;
+    };
+
+    /// @brief Moves to the next newline after `scan`. Returns `nullptr` if there is none before `end`.
+    const char* find_newline() noexcept;
+
+    /// @brief Continues with the other buffer, carrying [`pos`, `end`) over.
+    /// @return `false` at the end of the input.
+    bool refill(size_type carry);
+
+    /// @brief Fills `b` with one `read` call.
+    void fill(buffer& b);
+
+    /// @brief Waits until the other buffer is filled (or fills it without prefetching).
+    buffer& acquire_next();
+
+    void prefetch_loop();
+
+    /// @brief Applies the policy to a line which is too long. Returns `true` if it must be yielded.
+    bool handle_long_line(std::string_view& line);
+
+    int fd;
+    line_reader_options options;
+
+    buffer buffers[2];
+    size_type current = 0;
+
+    // The parser: the line starts at `pos`, and `mask` has the newlines in [`scan`, `scan + 64`)
+    // which are after `pos`.
+    const char* pos = nullptr;
+    const char* end = nullptr;
+    const char* scan = nullptr;
+    std::uint64_t mask = 0;
+
+    /// @brief The rest of a line that was too long is being dropped.
+    bool discarding = false;
+    bool finished = false;
+    bool started = false;
+    size_type count = 0;
+
+    // The prefetch thread.
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_type next_to_fill = 0;
+    bool stopping = false;
+    int error = 0;
+};
+
+template <std::size_t N>
+ash::line_reader<N>::line_reader(int fd, const line_reader_options& options) : fd(fd), options(options) {
+    if (this->options.chunk_size < padding)
+        this->options.chunk_size = padding;
+
+    for (buffer& b : buffers)
+        b.data.reset(new char[headroom + this->options.chunk_size + padding]);
+
+    // Nothing is consumed yet, so the first `refill` starts with an empty "previous chunk".
+    pos = end = scan = buffers[1].data.get() + headroom;
+    current = 1;
+
+    if (this->options.prefetch)
+        worker = std::thread(&line_reader::prefetch_loop, this);
+}
+
+template <std::size_t N>
+ash::line_reader<N>::~line_reader() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        changed.notify_all();
+        worker.join();
+    }
+}
+
+template <std::size_t N>
+bool ash::line_reader<N>::next(std::string_view& line) {
+    for (;;) {
+        const char* newline = find_newline();
+
+        if (newline == nullptr) {
+            size_type unfinished = end - pos;
+
+            if (finished) {
+                // The last line may not end with a newline.
+                if (unfinished == 0 || discarding)
+                    return false;
+
+                line = std::string_view(pos, unfinished);
+                pos = end;
+
+                if (unfinished > N && !handle_long_line(line))
+                    return false;
+
+                ++count;
+                return true;
+            }
+
+            if (discarding) {
+                pos = end;
+                unfinished = 0;
+            }
+            else if (unfinished > N) {
+                // It can't be carried over. It's dropped in pieces until its newline shows up.
+                line = std::string_view(pos, unfinished);
+                pos = end;
+
+                bool yield = handle_long_line(line);
+                discarding = true;
+
+                if (yield) {
+                    ++count;
+                    return true;
+                }
+
+                unfinished = 0;
+            }
+
+            if (!refill(unfinished))
+                finished = true;
+
+            continue;
+        }
+
+        line = std::string_view(pos, newline - pos);
+        pos = newline + 1;
+
+        if (discarding) {
+            discarding = false;
+            continue;
+        }
+
+        if (line.size() > N && !handle_long_line(line))
+            continue;
+
+        ++count;
+        return true;
+    }
+}
+
+template <std::size_t N>
+bool ash::line_reader<N>::next(value_type& line) {
+    std::string_view view;
+    if (!next(view))
+        return false;
+
+    line.resize_and_overwrite(view.size(), [&view](char* out, size_type) {
+        std::memcpy(out, view.data(), view.size());
+        return view.size();
+    });
+
+    return true;
+}
+
+template <std::size_t N>
+typename ash::line_reader<N>::size_type ash::line_reader<N>::lines() const noexcept {
+    return count;
+}
+
+template <std::size_t N>
+const char* ash::line_reader<N>::find_newline() noexcept {
+    while (mask == 0) {
+        if (scan + 64 >= end)
+            return nullptr;
+
+        scan += 64;
+        mask = ash::simd::match_mask64(scan, '\n');
+
+        if (end - scan < 64)
+            mask &= (std::uint64_t(1) << (end - scan)) - 1;
+    }
+
+    const char* newline = scan + ash::simd::ctz(mask);
+    mask &= mask - 1;
+
+    return newline;
+}
+
+template <std::size_t N>
+bool ash::line_reader<N>::refill(size_type carry) {
+    buffer& old = buffers[current];
+    buffer& fresh = acquire_next();
+
+    char* chunk = fresh.data.get() + headroom;
+    std::memcpy(chunk - carry, pos, carry);
+
+    // Only now the old buffer can be filled again. Before the first chunk, there is no old buffer.
+    if (started) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            old.ready = false;
+            old.size = 0;
+        }
+        changed.notify_all();
+    }
+
+    started = true;
+
+    current ^= 1;
+    pos = chunk - carry;
+    end = chunk + fresh.size;
+
+    // The carried characters have no newline. The scan starts with the first block of the chunk,
+    // which `find_newline` loads by stepping 64 bytes forward.
+    scan = chunk - 64;
+    mask = 0;
+
+    return fresh.size != 0;
+}
+
+template <std::size_t N>
+void ash::line_reader<N>::fill(buffer& b) {
+    char* chunk = b.data.get() + headroom;
+
+    for (;;) {
+        ssize_t n = ::read(fd, chunk, options.chunk_size);
+
+        if (n >= 0) {
+            b.size = static_cast<size_type>(n);
+            return;
+        }
+
+        if (errno != EINTR)
+            throw std::system_error(errno, std::generic_category(), "read");
+    }
+}
+
+template <std::size_t N>
+typename ash::line_reader<N>::buffer& ash::line_reader<N>::acquire_next() {
+    buffer& b = buffers[current ^ 1];
+
+    if (!options.prefetch) {
+        fill(b);
+        return b;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this, &b] { return b.ready || error != 0; });
+
+    if (!b.ready)
+        throw std::system_error(error, std::generic_category(), "read");
+
+    return b;
+}
+
+template <std::size_t N>
+void ash::line_reader<N>::prefetch_loop() {
+    for (;;) {
+        buffer& b = buffers[next_to_fill];
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this, &b] { return stopping || !b.ready; });
+
+            if (stopping)
+                return;
+        }
+
+        // The consumer doesn't touch `b` until it is ready (except its headroom), so the read
+        // doesn't need the lock.
+        int failure = 0;
+        try {
+            fill(b);
+        }
+        catch (const std::system_error& e) {
+            failure = e.code().value();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failure)
+                error = failure;
+            else
+                b.ready = true;
+        }
+        changed.notify_all();
+
+        if (failure || b.size == 0)
+            return;
+
+        next_to_fill ^= 1;
+    }
+}
+
+template <std::size_t N>
+bool ash::line_reader<N>::handle_long_line(std::string_view& line) {
+    switch (options.long_lines) {
+        case long_line_policy::truncate:
+            line = line.substr(0, N);
+            return true;
+
+        case long_line_policy::skip:
+            return false;
+
+        case long_line_policy::error:
+        default:
+            throw std::length_error("ash::line_reader: The line is longer than the capacity.");
+    }
+}
+
+#endif // ASH_LINE_READER
@@ -0,0 +1,523 @@
+/*
+================================================================================
+  ash/mapped_static_string_array.h - Zero-copy files of `ash::basic_static_string` records.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::mapped_static_string_array<CharT, N>` maps a file with `mmap` and
+    exposes its records directly as a random-access range of
+    `basic_static_string<CharT, N>`. Opening a file doesn't read or parse
+    anything, the pages are loaded by the kernel when they are first used.
+
+    - `map_mode::read_only` maps the file read-only and shared, so all the
+      processes which map it share the same page cache.
+    - `map_mode::copy_on_write` maps it private and writable. Changes are
+      only visible to this mapping and never written back to the file.
+
+    The records are only accessed as `const`. `mutable_at` and `mutable_data`
+    give writable access, and throw unless the file is mapped with
+    `map_mode::copy_on_write` (writing to a read-only mapping would crash).
+
+    `advise` forwards an access pattern hint to `madvise`.
+
+    Files are written with `ash::mapped_static_string_array<CharT, N>::write`.
+
+  File layout (native byte order, checked when the file is opened):
+    Offset  Size  Field
+    0       8     magic         "ASHSSA\0\0"
+    8       4     version       1
+    12      4     byte_order    0x01020304, as written by the writer
+    16      4     char_size     sizeof(CharT)
+    20      4     size_width    sizeof(std::size_t)
+    24      8     capacity      N
+    32      8     count         number of records
+    40      8     record_size   sizeof(basic_static_string<CharT, N>)
+    48      8     size_offset   offset of the size inside a record
+    56      8     reserved      0
+    64      ...   records
+
+    A record is the in-memory representation of `basic_static_string<CharT,
+    N>`: `N + 1` characters (the string, padded with nulls), then the size at
+    `size_offset`. The padding bytes in between are zero.
+
+  Usage:
+    #include "ash/mapped_static_string_array.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_MAPPED_STATIC_STRING_ARRAY
+
+================================================================================
+*/
+
+#ifndef ASH_MAPPED_STATIC_STRING_ARRAY
+#define ASH_MAPPED_STATIC_STRING_ARRAY
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @brief How `mapped_static_string_array` maps a file.
+    enum class map_mode {
+        read_only,
+        copy_on_write
+    };
+
+    /// @brief Access patterns for `mapped_static_string_array::advise`.
+    enum class access_hint {
+        normal,
+        sequential,
+        random,
+        will_need,
+        dont_need
+    };
+
+    /// @class mapped_static_string_array
+    /// @brief A file of `basic_static_string<CharT, N>` records mapped into memory.
+    /// @tparam CharT Character type.
+    /// @tparam N Capacity of the strings.
+    template <class CharT, std::size_t N>
+    class mapped_static_string_array;
+}
+
+template <class CharT, std::size_t N>
+class ash::mapped_static_string_array {
+public:
+    using value_type = basic_static_string<CharT, N>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    /// @brief The records are only writable through `mutable_at` and `mutable_data`.
+    using iterator = const value_type*;
+    using const_iterator = const value_type*;
+
+    static_assert(std::is_standard_layout<value_type>::value,
+        "ash::mapped_static_string_array: basic_static_string must be standard-layout.");
+
+    /// @brief The offset of the size inside a record. It is the last member.
+    static constexpr size_type size_offset = sizeof(value_type) - sizeof(size_type);
+
+    /// @brief The version of the file layout.
+    static constexpr std::uint32_t layout_version = 1;
+
+    /// @brief The size of the file header. The records start right after it.
+    static constexpr size_type header_size = 64;
+
+private:
+    struct file_header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint32_t char_size;
+        std::uint32_t size_width;
+        std::uint64_t capacity;
+        std::uint64_t count;
+        std::uint64_t record_size;
+        std::uint64_t size_offset;
+        std::uint64_t reserved;
+    };
+
+    static_assert(sizeof(file_header) == header_size, "ash::mapped_static_string_array: Unexpected header padding.");
+
+public:
+
+// Constructors
+
+    /// @brief Constructs an empty array, which doesn't map anything.
+    mapped_static_string_array() noexcept = default;
+
+    /// @brief Maps the file at `path`.
+    /// @exception `std::system_error` if a system call fails.
+    /// @exception `std::runtime_error` if the file wasn't written for this `CharT` and `N` (or on
+    /// this platform), or is truncated.
+    explicit mapped_static_string_array(const char* path, map_mode mode = map_mode::read_only);
+
+    mapped_static_string_array(mapped_static_string_array&& other) noexcept;
+    mapped_static_string_array& operator=(mapped_static_string_array&& other) noexcept;
+
+    mapped_static_string_array(const mapped_static_string_array&) = delete;
+    mapped_static_string_array& operator=(const mapped_static_string_array&) = delete;
+
+    /// @brief Unmaps the file.
+    ~mapped_static_string_array();
+
+    /// @brief Writes the strings in [`first`, `last`) into a new file at `path` (replacing it).
+    /// @param first Iterators to `basic_static_string<CharT, M>`s, string views, or anything else
+    /// with `data()` and `size()`.
+    /// @return The number of records written.
+    /// @exception `std::out_of_range` if a string is longer than `N`.
+    /// @exception `std::system_error` if a system call fails.
+    template <class InputIt>
+    static size_type write(const char* path, InputIt first, InputIt last);
+
+// Element access
+
+    /// @brief No bounds checking is performed.
+    const_reference operator[](size_type pos) const noexcept;
+
+    /// @exception `std::out_of_range` if `pos` is equal or more than `size()`.
+    const_reference at(size_type pos) const;
+
+    /// @brief A writable reference to the record at `pos`.
+    /// @exception `std::logic_error` if the file isn't mapped with `map_mode::copy_on_write`.
+    /// @exception `std::out_of_range` if `pos` is equal or more than `size()`.
+    reference mutable_at(size_type pos);
+
+    /// @brief The first record.
+    const value_type* data() const noexcept;
+
+    /// @brief The first record, writable.
+    /// @exception `std::logic_error` if the file isn't mapped with `map_mode::copy_on_write`.
+    value_type* mutable_data();
+
+// Iterators
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+// Capacity
+
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+
+// Operations
+
+    /// @brief Tells the kernel how the records are going to be accessed (`madvise`).
+    /// @exception `std::system_error` if `madvise` fails.
+    void advise(access_hint hint) const;
+
+    /// @brief Checks every record: the size is at most `N` and the unused characters are null.
+    /// @note Reads the whole file. Worth it for files from untrusted sources, since a record with
+    /// a broken size makes the string read out of its bounds.
+    bool validate() const noexcept;
+
+private:
+    void unmap() noexcept;
+
+    /// @exception `std::logic_error` if the file isn't mapped with `map_mode::copy_on_write`.
+    void throw_if_read_only() const;
+
+    void* mapping = nullptr;
+    size_type mapped_bytes = 0;
+    value_type* records = nullptr;
+    size_type count = 0;
+    bool writable = false;
+};
+
+#define ASH_mssa_template template <class CharT, std::size_t N>
+#define ASH_mssa_name ash::mapped_static_string_array<CharT, N>
+
+ASH_mssa_template
+ASH_mssa_name::mapped_static_string_array(const char* path, map_mode mode) {
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "open");
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat");
+    }
+
+    size_type bytes = static_cast<size_type>(info.st_size);
+    if (bytes < header_size) {
+        ::close(fd);
+        throw std::runtime_error("ash::mapped_static_string_array: The file is too small.");
+    }
+
+    int protection = (mode == map_mode::read_only) ? PROT_READ : (PROT_READ | PROT_WRITE);
+    int flags = (mode == map_mode::read_only) ? MAP_SHARED : MAP_PRIVATE;
+
+    void* memory = ::mmap(nullptr, bytes, protection, flags, fd, 0);
+    int error = errno;
+    ::close(fd);
+
+    if (memory == MAP_FAILED)
+        throw std::system_error(error, std::generic_category(), "mmap");
+
+    mapping = memory;
+    mapped_bytes = bytes;
+
+    file_header header;
+    std::memcpy(&header, memory, sizeof(header));
+
+    const char* problem = nullptr;
+
+    if (std::memcmp(header.magic, "ASHSSA\0\0", 8) != 0 || header.version != layout_version)
+        problem = "ash::mapped_static_string_array: Not a static string array file (or an unsupported version).";
+    else if (header.byte_order != 0x01020304u || header.size_width != sizeof(size_type))
+        problem = "ash::mapped_static_string_array: The file was written on a platform with a different byte order or word size.";
+    else if (header.char_size != sizeof(CharT) || header.capacity != N
+        || header.record_size != sizeof(value_type) || header.size_offset != size_offset)
+        problem = "ash::mapped_static_string_array: The file was written for a different CharT or N.";
+    else if (header.count > (bytes - header_size) / sizeof(value_type))
+        problem = "ash::mapped_static_string_array: The file is truncated.";
+
+    if (problem) {
+        unmap();
+        throw std::runtime_error(problem);
+    }
+
+    records = reinterpret_cast<value_type*>(static_cast<unsigned char*>(memory) + header_size);
+    count = static_cast<size_type>(header.count);
+    writable = (mode == map_mode::copy_on_write);
+}
+
+ASH_mssa_template
+ASH_mssa_name::mapped_static_string_array(mapped_static_string_array&& other) noexcept
+    : mapping(other.mapping), mapped_bytes(other.mapped_bytes), records(other.records), count(other.count),
+      writable(other.writable) {
+    other.mapping = nullptr;
+    other.mapped_bytes = 0;
+    other.records = nullptr;
+    other.count = 0;
+    other.writable = false;
+}
+
+ASH_mssa_template
+ASH_mssa_name& ASH_mssa_name::operator=(mapped_static_string_array&& other) noexcept {
+    if (this != &other) {
+        unmap();
+
+        mapping = other.mapping;
+        mapped_bytes = other.mapped_bytes;
+        records = other.records;
+        count = other.count;
+        writable = other.writable;
+
+        other.mapping = nullptr;
+        other.mapped_bytes = 0;
+        other.records = nullptr;
+        other.count = 0;
+        other.writable = false;
+    }
+
+    return *this;
+}
+
+ASH_mssa_template
+ASH_mssa_name::~mapped_static_string_array() {
+    unmap();
+}
+
+ASH_mssa_template
+template <class InputIt>
+typename ASH_mssa_name::size_type ASH_mssa_name::write(const char* path, InputIt first, InputIt last) {
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "open");
+
+    auto write_all = [fd](const unsigned char* p, size_type n, off_t offset) {
+        while (n) {
+            ssize_t written = ::pwrite(fd, p, n, offset);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                throw std::system_error(errno, std::generic_category(), "pwrite");
+            }
+
+            p += written;
+            n -= static_cast<size_type>(written);
+            offset += written;
+        }
+    };
+
+    try {
+        // Records are written in batches of about 1 MiB. The header goes last, once the count
+        // is known.
+        const size_type batch = (size_type(1) << 20) / sizeof(value_type) + 1;
+        std::vector<unsigned char> buffer;
+        buffer.reserve(batch * sizeof(value_type));
+
+        off_t offset = header_size;
+        size_type written = 0;
+
+        for (; first != last; ++first) {
+            const auto& str = *first;
+            ash::throw_if_outside_of_capacity<size_type>(N, str.size());
+
+            // Zero-filled, so the padding and the unused characters are zero in the file.
+            size_type record = buffer.size();
+            buffer.resize(record + sizeof(value_type));
+
+            std::memcpy(buffer.data() + record, str.data(), str.size() * sizeof(CharT));
+
+            size_type size = str.size();
+            std::memcpy(buffer.data() + record + size_offset, &size, sizeof(size));
+
+            ++written;
+
+            if (buffer.size() == batch * sizeof(value_type)) {
+                write_all(buffer.data(), buffer.size(), offset);
+                offset += static_cast<off_t>(buffer.size());
+                buffer.clear();
+            }
+        }
+
+        write_all(buffer.data(), buffer.size(), offset);
+
+        file_header header {};
+        std::memcpy(header.magic, "ASHSSA\0\0", 8);
+        header.version = layout_version;
+        header.byte_order = 0x01020304u;
+        header.char_size = sizeof(CharT);
+        header.size_width = sizeof(size_type);
+        header.capacity = N;
+        header.count = written;
+        header.record_size = sizeof(value_type);
+        header.size_offset = size_offset;
+
+        write_all(reinterpret_cast<const unsigned char*>(&header), sizeof(header), 0);
+
+        if (::close(fd) != 0)
+            throw std::system_error(errno, std::generic_category(), "close");
+
+        return written;
+    }
+    catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::const_reference ASH_mssa_name::operator[](size_type pos) const noexcept {
+    return records[pos];
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::const_reference ASH_mssa_name::at(size_type pos) const {
+    ash::throw_if_outside_of_size(count, pos);
+    return records[pos];
+}
+
+ASH_mssa_template
+const typename ASH_mssa_name::value_type* ASH_mssa_name::data() const noexcept {
+    return records;
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::reference ASH_mssa_name::mutable_at(size_type pos) {
+    throw_if_read_only();
+    ash::throw_if_outside_of_size(count, pos);
+    return records[pos];
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::value_type* ASH_mssa_name::mutable_data() {
+    throw_if_read_only();
+    return records;
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::const_iterator ASH_mssa_name::begin() const noexcept {
+    return records;
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::const_iterator ASH_mssa_name::end() const noexcept {
+    return records + count;
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::const_iterator ASH_mssa_name::cbegin() const noexcept {
+    return begin();
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::const_iterator ASH_mssa_name::cend() const noexcept {
+    return end();
+}
+
+ASH_mssa_template
+bool ASH_mssa_name::empty() const noexcept {
+    return count == 0;
+}
+
+ASH_mssa_template
+typename ASH_mssa_name::size_type ASH_mssa_name::size() const noexcept {
+    return count;
+}
+
+ASH_mssa_template
+void ASH_mssa_name::advise(access_hint hint) const {
+    if (mapping == nullptr)
+        return;
+
+    int advice = MADV_NORMAL;
+    switch (hint) {
+        case access_hint::normal: advice = MADV_NORMAL; break;
+        case access_hint::sequential: advice = MADV_SEQUENTIAL; break;
+        case access_hint::random: advice = MADV_RANDOM; break;
+        case access_hint::will_need: advice = MADV_WILLNEED; break;
+        case access_hint::dont_need: advice = MADV_DONTNEED; break;
+    }
+
+    if (::madvise(mapping, mapped_bytes, advice) != 0)
+        throw std::system_error(errno, std::generic_category(), "madvise");
+}
+
+ASH_mssa_template
+bool ASH_mssa_name::validate() const noexcept {
+    for (size_type i = 0; i < count; ++i) {
+        const unsigned char* record = reinterpret_cast<const unsigned char*>(records + i);
+
+        size_type size;
+        std::memcpy(&size, record + size_offset, sizeof(size));
+        if (size > N)
+            return false;
+
+        const CharT* chars = reinterpret_cast<const CharT*>(record);
+        for (size_type k = size; k <= N; ++k)
+            if (chars[k] != CharT())
+                return false;
+    }
+
+    return true;
+}
+
+ASH_mssa_template
+void ASH_mssa_name::unmap() noexcept {
+    if (mapping)
+        ::munmap(mapping, mapped_bytes);
+
+    mapping = nullptr;
+    mapped_bytes = 0;
+    records = nullptr;
+    count = 0;
+    writable = false;
+}
+
+ASH_mssa_template
+void ASH_mssa_name::throw_if_read_only() const {
+    if (!writable)
+        throw std::logic_error("ash::mapped_static_string_array: The file isn't mapped with map_mode::copy_on_write.");
+}
+
+#undef ASH_mssa_template
+#undef ASH_mssa_name
+
+#endif // ASH_MAPPED_STATIC_STRING_ARRAY
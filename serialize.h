@@ -0,0 +1,474 @@
+/*
+================================================================================
+  ash/serialize.h - Binary serialization of `ash::basic_static_string`s.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::serialize` / `ash::deserialize` for `basic_static_string<CharT, N>`
+    (of any alignment, which doesn't change the format) and `std::array`s /
+    `std::vector`s of them, in two encodings:
+
+    - `ash::encoding::fixed`: The size as a 32-bit integer, then all the `N`
+      characters (null-padded). Every string takes the same number of bytes,
+      so a record is one `memcpy` and the `i`th record can be found directly.
+    - `ash::encoding::varint`: The size as a LEB128 varint, then only the
+      used characters. This is the compact one, meant for the wire.
+
+    Everything is little-endian (characters wider than a byte included), so
+    the output is the same on every platform. On little-endian platforms the
+    characters are copied as they are.
+
+    `ash::byte_writer` writes into a caller buffer (bounds-checked) or
+    appends to a `std::vector<std::byte>`. `ash::byte_reader` reads from a
+    buffer without allocating; reading past its end throws instead of
+    reading garbage. Both accept `std::span` in C++20.
+
+    The count of a `std::vector` is written as a 64-bit integer (`fixed`) or
+    a varint (`varint`). The count of a `std::array` isn't written at all.
+
+  Usage:
+    #include "ash/serialize.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_SERIALIZE
+
+================================================================================
+*/
+
+#ifndef ASH_SERIALIZE
+#define ASH_SERIALIZE
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+#if __cplusplus >= __cpp20
+#include <span>
+#endif
+
+namespace ash {
+    /// @brief The encodings of `ash::serialize`.
+    enum class encoding {
+        /// @brief 32-bit size and all the `N` characters.
+        fixed,
+
+        /// @brief Varint size and only the used characters.
+        varint
+    };
+
+    /// @class byte_writer
+    /// @brief Writes bytes into a caller buffer, or appends them to a `std::vector<std::byte>`.
+    class byte_writer;
+
+    /// @class byte_reader
+    /// @brief Reads bytes from a buffer. Never reads past its end.
+    class byte_reader;
+
+    /// @brief Writes `str` in the `E` encoding.
+    /// @exception `std::out_of_range` if the buffer of `out` is full.
+    template <encoding E = encoding::varint, class CharT, std::size_t N, std::size_t Align>
+    void serialize(byte_writer& out, const basic_static_string<CharT, N, Align>& str);
+
+    /// @brief Writes every string in `arr`, without the count.
+    template <encoding E = encoding::varint, class CharT, std::size_t N, std::size_t Align, std::size_t M>
+    void serialize(byte_writer& out, const std::array<basic_static_string<CharT, N, Align>, M>& arr);
+
+    /// @brief Writes the count, then every string in `vec`.
+    template <encoding E = encoding::varint, class CharT, std::size_t N, std::size_t Align, class Alloc>
+    void serialize(byte_writer& out, const std::vector<basic_static_string<CharT, N, Align>, Alloc>& vec);
+
+    /// @brief Reads a string written by `serialize<E>`.
+    /// @exception `std::out_of_range` if the input ends early or the size is more than `N`.
+    /// @exception `std::invalid_argument` if a varint is malformed.
+    template <encoding E = encoding::varint, class CharT, std::size_t N, std::size_t Align>
+    void deserialize(byte_reader& in, basic_static_string<CharT, N, Align>& str);
+
+    /// @brief Reads `M` strings written by `serialize<E>`.
+    template <encoding E = encoding::varint, class CharT, std::size_t N, std::size_t Align, std::size_t M>
+    void deserialize(byte_reader& in, std::array<basic_static_string<CharT, N, Align>, M>& arr);
+
+    /// @brief Reads the count, then the strings written by `serialize<E>`. Replaces the contents of `vec`.
+    template <encoding E = encoding::varint, class CharT, std::size_t N, std::size_t Align, class Alloc>
+    void deserialize(byte_reader& in, std::vector<basic_static_string<CharT, N, Align>, Alloc>& vec);
+
+    /// @brief The number of bytes `serialize<E>(out, str)` writes.
+    template <encoding E = encoding::varint, class CharT, std::size_t N, std::size_t Align>
+    constexpr std::size_t serialized_size(const basic_static_string<CharT, N, Align>& str) noexcept;
+
+    namespace __serialize_details {
+        /// @brief The number of bytes of `value` as a varint.
+        constexpr std::size_t varint_size(std::uint64_t value) noexcept;
+
+        /// @brief Writes `count` characters, little-endian.
+        template <class CharT>
+        void write_chars(byte_writer& out, const CharT* chars, std::size_t count);
+
+        /// @brief Reads `count` characters, little-endian.
+        template <class CharT>
+        void read_chars(byte_reader& in, CharT* chars, std::size_t count);
+    }
+}
+
+class ash::byte_writer {
+public:
+
+// Constructors
+
+    /// @brief Writes into [`data`, `data + size`).
+    byte_writer(std::byte* data, std::size_t size) noexcept;
+
+#if __cplusplus >= __cpp20
+    /// @brief Writes into `buffer`.
+    explicit byte_writer(std::span<std::byte> buffer) noexcept;
+#endif
+
+    /// @brief Appends to `out`, which grows as needed. `position()` counts the bytes which were
+    /// already in `out` too.
+    explicit byte_writer(std::vector<std::byte>& out) noexcept;
+
+// Capacity
+
+    /// @brief The number of bytes written so far.
+    std::size_t position() const noexcept;
+
+// Operations
+
+    /// @brief Writes `count` bytes from `bytes`.
+    /// @exception `std::out_of_range` if there isn't enough room in the buffer.
+    void write(const void* bytes, std::size_t count);
+
+    void write_u32(std::uint32_t value);
+    void write_u64(std::uint64_t value);
+    void write_varint(std::uint64_t value);
+
+    /// @brief Makes room for `count` more bytes and returns a pointer to them. The caller must
+    /// write all of them.
+    /// @exception `std::out_of_range` if there isn't enough room in the buffer.
+    std::byte* reserve(std::size_t count);
+
+private:
+    std::byte* first = nullptr;
+    std::byte* current = nullptr;
+    std::byte* last = nullptr;
+    std::vector<std::byte>* sink = nullptr;
+};
+
+class ash::byte_reader {
+public:
+
+// Constructors
+
+    /// @brief Reads from [`data`, `data + size`).
+    byte_reader(const std::byte* data, std::size_t size) noexcept;
+
+#if __cplusplus >= __cpp20
+    /// @brief Reads from `buffer`.
+    explicit byte_reader(std::span<const std::byte> buffer) noexcept;
+#endif
+
+// Capacity
+
+    /// @brief The number of bytes read so far.
+    std::size_t position() const noexcept;
+
+    /// @brief The number of bytes left.
+    std::size_t remaining() const noexcept;
+
+// Operations
+
+    /// @brief Copies the next `count` bytes into `bytes`.
+    /// @exception `std::out_of_range` if fewer than `count` bytes are left.
+    void read(void* bytes, std::size_t count);
+
+    std::uint32_t read_u32();
+    std::uint64_t read_u64();
+
+    /// @exception `std::invalid_argument` if the varint is longer than 10 bytes or overflows.
+    std::uint64_t read_varint();
+
+    /// @brief Skips the next `count` bytes and returns a pointer to them (without copying).
+    /// @exception `std::out_of_range` if fewer than `count` bytes are left.
+    const std::byte* take(std::size_t count);
+
+private:
+    const std::byte* first;
+    const std::byte* current;
+    const std::byte* last;
+};
+
+
+inline ash::byte_writer::byte_writer(std::byte* data, std::size_t size) noexcept
+    : first(data), current(data), last(data + size) {}
+
+#if __cplusplus >= __cpp20
+inline ash::byte_writer::byte_writer(std::span<std::byte> buffer) noexcept
+    : byte_writer(buffer.data(), buffer.size()) {}
+#endif
+
+inline ash::byte_writer::byte_writer(std::vector<std::byte>& out) noexcept
+    : first(out.data()), current(out.data() + out.size()), last(out.data() + out.size()), sink(&out) {}
+
+inline std::size_t ash::byte_writer::position() const noexcept {
+    return current - first;
+}
+
+inline void ash::byte_writer::write(const void* bytes, std::size_t count) {
+    if (count)
+        std::memcpy(reserve(count), bytes, count);
+}
+
+inline void ash::byte_writer::write_u32(std::uint32_t value) {
+    unsigned char bytes[4];
+    for (std::size_t i = 0; i < 4; ++i)
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+
+    write(bytes, 4);
+}
+
+inline void ash::byte_writer::write_u64(std::uint64_t value) {
+    unsigned char bytes[8];
+    for (std::size_t i = 0; i < 8; ++i)
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+
+    write(bytes, 8);
+}
+
+inline void ash::byte_writer::write_varint(std::uint64_t value) {
+    unsigned char bytes[10];
+    std::size_t n = 0;
+
+    while (value >= 0x80) {
+        bytes[n++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    bytes[n++] = static_cast<unsigned char>(value);
+
+    write(bytes, n);
+}
+
+inline std::byte* ash::byte_writer::reserve(std::size_t count) {
+    if (sink) {
+        // The vector may reallocate, so the pointers are taken again.
+        std::size_t written = sink->size();
+        sink->resize(written + count);
+
+        first = sink->data();
+        current = first + written + count;
+        last = current;
+
+        return current - count;
+    }
+
+    ash::throw_if_outside_of_capacity<std::size_t>(last - current, count);
+
+    current += count;
+    return current - count;
+}
+
+inline ash::byte_reader::byte_reader(const std::byte* data, std::size_t size) noexcept
+    : first(data), current(data), last(data + size) {}
+
+#if __cplusplus >= __cpp20
+inline ash::byte_reader::byte_reader(std::span<const std::byte> buffer) noexcept
+    : byte_reader(buffer.data(), buffer.size()) {}
+#endif
+
+inline std::size_t ash::byte_reader::position() const noexcept {
+    return current - first;
+}
+
+inline std::size_t ash::byte_reader::remaining() const noexcept {
+    return last - current;
+}
+
+inline void ash::byte_reader::read(void* bytes, std::size_t count) {
+    if (count)
+        std::memcpy(bytes, take(count), count);
+}
+
+inline std::uint32_t ash::byte_reader::read_u32() {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(take(4));
+
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; ++i)
+        value |= std::uint32_t(bytes[i]) << (8 * i);
+
+    return value;
+}
+
+inline std::uint64_t ash::byte_reader::read_u64() {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(take(8));
+
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < 8; ++i)
+        value |= std::uint64_t(bytes[i]) << (8 * i);
+
+    return value;
+}
+
+inline std::uint64_t ash::byte_reader::read_varint() {
+    std::uint64_t value = 0;
+
+    for (std::size_t shift = 0; shift < 64; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(*take(1));
+
+        // The 10th byte may only hold the last bit.
+        if (shift == 63 && byte > 1)
+            throw std::invalid_argument("ash::byte_reader: The varint overflows 64 bits.");
+
+        value |= std::uint64_t(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+
+    throw std::invalid_argument("ash::byte_reader: The varint is too long.");
+}
+
+inline const std::byte* ash::byte_reader::take(std::size_t count) {
+    ash::throw_if_outside_of_capacity<std::size_t>(last - current, count);
+
+    current += count;
+    return current - count;
+}
+
+constexpr std::size_t ash::__serialize_details::varint_size(std::uint64_t value) noexcept {
+    std::size_t n = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++n;
+    }
+
+    return n;
+}
+
+template <class CharT>
+void ash::__serialize_details::write_chars(byte_writer& out, const CharT* chars, std::size_t count) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    out.write(chars, count * sizeof(CharT));
+#else
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(out.reserve(count * sizeof(CharT)));
+
+    for (std::size_t i = 0; i < count; ++i) {
+        auto unit = static_cast<std::uint64_t>(chars[i]);
+        for (std::size_t b = 0; b < sizeof(CharT); ++b)
+            *bytes++ = static_cast<unsigned char>(unit >> (8 * b));
+    }
+#endif
+}
+
+template <class CharT>
+void ash::__serialize_details::read_chars(byte_reader& in, CharT* chars, std::size_t count) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    in.read(chars, count * sizeof(CharT));
+#else
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(in.take(count * sizeof(CharT)));
+
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t unit = 0;
+        for (std::size_t b = 0; b < sizeof(CharT); ++b)
+            unit |= std::uint64_t(*bytes++) << (8 * b);
+
+        chars[i] = static_cast<CharT>(unit);
+    }
+#endif
+}
+
+template <ash::encoding E, class CharT, std::size_t N, std::size_t Align>
+void ash::serialize(byte_writer& out, const basic_static_string<CharT, N, Align>& str) {
+    static_assert(N <= UINT32_MAX, "ash::serialize: N must fit in 32 bits.");
+
+    if constexpr (E == encoding::fixed) {
+        out.write_u32(static_cast<std::uint32_t>(str.size()));
+
+        // The rest of the `N` characters is written as zeros, not copied: the buffer after the
+        // size isn't always initialized (C++20), and its bytes must not end up in the output.
+        __serialize_details::write_chars(out, str.data(), str.size());
+
+        std::size_t padding = (N - str.size()) * sizeof(CharT);
+        if (padding != 0)
+            std::memset(out.reserve(padding), 0, padding);
+    }
+    else {
+        out.write_varint(str.size());
+        __serialize_details::write_chars(out, str.data(), str.size());
+    }
+}
+
+template <ash::encoding E, class CharT, std::size_t N, std::size_t Align, std::size_t M>
+void ash::serialize(byte_writer& out, const std::array<basic_static_string<CharT, N, Align>, M>& arr) {
+    for (const auto& str : arr)
+        ash::serialize<E>(out, str);
+}
+
+template <ash::encoding E, class CharT, std::size_t N, std::size_t Align, class Alloc>
+void ash::serialize(byte_writer& out, const std::vector<basic_static_string<CharT, N, Align>, Alloc>& vec) {
+    if constexpr (E == encoding::fixed)
+        out.write_u64(vec.size());
+    else
+        out.write_varint(vec.size());
+
+    for (const auto& str : vec)
+        ash::serialize<E>(out, str);
+}
+
+template <ash::encoding E, class CharT, std::size_t N, std::size_t Align>
+void ash::deserialize(byte_reader& in, basic_static_string<CharT, N, Align>& str) {
+    std::uint64_t size = (E == encoding::fixed) ? in.read_u32() : in.read_varint();
+    ash::throw_if_outside_of_capacity<std::uint64_t>(N, size);
+
+    str.resize_and_overwrite(static_cast<std::size_t>(size), [&in](CharT* chars, std::size_t count) {
+        __serialize_details::read_chars(in, chars, count);
+        return count;
+    });
+
+    if constexpr (E == encoding::fixed)
+        in.take((N - str.size()) * sizeof(CharT));
+}
+
+template <ash::encoding E, class CharT, std::size_t N, std::size_t Align, std::size_t M>
+void ash::deserialize(byte_reader& in, std::array<basic_static_string<CharT, N, Align>, M>& arr) {
+    for (auto& str : arr)
+        ash::deserialize<E>(in, str);
+}
+
+template <ash::encoding E, class CharT, std::size_t N, std::size_t Align, class Alloc>
+void ash::deserialize(byte_reader& in, std::vector<basic_static_string<CharT, N, Align>, Alloc>& vec) {
+    std::uint64_t count = (E == encoding::fixed) ? in.read_u64() : in.read_varint();
+
+    // Every string takes at least one byte, so a count larger than the input is a lie and must
+    // not decide how much we allocate.
+    ash::throw_if_outside_of_capacity<std::uint64_t>(in.remaining(), count);
+
+    vec.resize(static_cast<std::size_t>(count));
+    for (auto& str : vec)
+        ash::deserialize<E>(in, str);
+}
+
+template <ash::encoding E, class CharT, std::size_t N, std::size_t Align>
+constexpr std::size_t ash::serialized_size(const basic_static_string<CharT, N, Align>& str) noexcept {
+    if constexpr (E == encoding::fixed)
+        return 4 + N * sizeof(CharT);
+    else
+        return __serialize_details::varint_size(str.size()) + str.size() * sizeof(CharT);
+}
+
+// The alignment of a string doesn't change its encoding.
+static_assert(ash::serialized_size<ash::encoding::fixed>(ash::aligned_static_string<20, 64>("key"))
+              == ash::serialized_size<ash::encoding::fixed>(ash::static_string<20>("key")),
+              "ash::serialize: the alignment must not change the fixed encoding.");
+static_assert(ash::serialized_size<ash::encoding::varint>(ash::aligned_static_string<20, 64>("key"))
+              == ash::serialized_size<ash::encoding::varint>(ash::static_string<20>("key")),
+              "ash::serialize: the alignment must not change the varint encoding.");
+
+#endif // ASH_SERIALIZE
@@ -0,0 +1,494 @@
+/*
+================================================================================
+  ash/shm_ring.h - Lock-free rings of `ash::basic_static_string` messages in shared memory.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::basic_static_string` has a fixed size and no pointers, so it can be
+    passed between processes by copying its characters. `ash::shm_ring<T,
+    Capacity, Mode>` is a bounded ring of such messages which lives in a POSIX
+    shared-memory object (`create` / `open`) or in any memory you map yourself
+    (`attach`).
+
+    - `ash::ring_mode::spsc`: One producer and one consumer. Each side keeps
+      a private copy of the other side's position and only reads the shared
+      one when the copy says the ring is full (or empty).
+    - `ash::ring_mode::mpsc`: Many producers and one consumer (Dmitry Vyukov's
+      bounded queue). Every slot has a sequence number which tells whether it
+      is free, claimed or published.
+
+    The head and the tail are on separate cache lines, and `push` / `pop` have
+    batched versions which touch the shared positions once per batch.
+
+    The segment starts with a header (magic, layout version, mode, capacity,
+    character size and `N`), which `open` / `attach` check, so two programs
+    built with a different layout fail loudly instead of reading garbage.
+
+  Layout (all in native byte order):
+    [ header (64 bytes) | head (64 bytes) | tail (64 bytes) | Capacity slots ]
+    slot = { uint64 sequence, uint64 size, CharT chars[N] }
+
+  Usage:
+    #include "ash/shm_ring.h"
+
+    Link with `-lrt` on older glibc versions.
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_SHM_RING
+
+================================================================================
+*/
+
+#ifndef ASH_SHM_RING
+#define ASH_SHM_RING
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../ash/static_string.h"
+
+namespace ash {
+    /// @brief The number of producers a `shm_ring` supports. There is always one consumer.
+    enum class ring_mode : std::uint32_t {
+        spsc = 1,
+        mpsc = 2
+    };
+
+    /// @class shm_ring
+    /// @brief A bounded lock-free ring of `basic_static_string`s that can be shared between processes.
+    /// @tparam T A `basic_static_string<CharT, N>`.
+    /// @tparam Capacity The number of slots. Must be a power of two.
+    /// @tparam Mode `ring_mode::spsc` or `ring_mode::mpsc`.
+    template <class T, std::size_t Capacity, ring_mode Mode = ring_mode::spsc>
+    class shm_ring;
+}
+
+template <class T, std::size_t Capacity, ash::ring_mode Mode>
+class ash::shm_ring {
+    static_assert(ash::is_basic_static_string<T>::value, "ash::shm_ring: T must be a basic_static_string.");
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "ash::shm_ring: Capacity must be a power of two.");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "ash::shm_ring: needs lock-free 64-bit atomics.");
+
+public:
+    using value_type = T;
+    using char_type = typename T::value_type;
+    using size_type = std::size_t;
+
+    /// @brief Magic number at the beginning of the segment ("ASHRING" and a zero).
+    static constexpr std::uint64_t magic = 0x00474E4952485341ull;
+
+    /// @brief Changed whenever the layout changes.
+    static constexpr std::uint32_t layout_version = 1;
+
+private:
+    struct header {
+        std::atomic<std::uint64_t> magic;
+        std::uint32_t version;
+        std::uint32_t mode;
+        std::uint64_t capacity;
+        std::uint64_t slot_size;
+        std::uint32_t char_size;
+        std::uint32_t string_capacity;
+    };
+
+    struct slot {
+        std::atomic<std::uint64_t> sequence;
+        std::uint64_t size;
+        char_type chars[T::capacity()];
+    };
+
+    struct alignas(64) position {
+        std::atomic<std::uint64_t> value;
+    };
+
+    struct layout {
+        alignas(64) header info;
+        position head;
+        position tail;
+        slot slots[Capacity];
+    };
+
+public:
+    /// @brief The number of bytes needed by `attach`.
+    static constexpr size_type required_bytes = sizeof(layout);
+
+// Constructors
+
+    /// @brief Creates (or truncates) the POSIX shared-memory object `name` and initializes an empty ring in it.
+    /// @param name Name for `shm_open`, e.g. `"/logs"`.
+    /// @exception `std::system_error` if a system call fails.
+    static shm_ring create(const char* name, mode_t permissions = 0600);
+
+    /// @brief Opens the ring created under `name` by another process.
+    /// @exception `std::system_error` if a system call fails.
+    /// @exception `std::runtime_error` if the segment doesn't hold a ring with this exact layout.
+    static shm_ring open(const char* name);
+
+    /// @brief Uses `bytes` bytes at `memory` (e.g. a file you mapped yourself) without owning them.
+    /// @param memory Aligned to 64 bytes.
+    /// @param initialize If `true`, writes an empty ring. Otherwise checks the header like `open`.
+    /// @exception `std::runtime_error` if `memory` is too small, or the header doesn't match.
+    static shm_ring attach(void* memory, size_type bytes, bool initialize);
+
+    /// @brief Removes the shared-memory object `name`. Processes which already mapped it keep it.
+    static void unlink(const char* name) noexcept;
+
+    shm_ring(shm_ring&& other) noexcept;
+    shm_ring& operator=(shm_ring&& other) noexcept;
+
+    shm_ring(const shm_ring&) = delete;
+    shm_ring& operator=(const shm_ring&) = delete;
+
+    /// @brief Unmaps the segment if it was mapped by `create` or `open`.
+    ~shm_ring();
+
+// Capacity
+
+    static constexpr size_type capacity() noexcept { return Capacity; }
+
+    /// @brief The number of messages in the ring. Only a hint while others are pushing or popping.
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+
+// Producer
+
+    /// @brief Pushes `value` if there is room.
+    /// @return `false` if the ring is full.
+    bool try_push(const value_type& value) noexcept;
+
+    /// @brief Pushes as many of [`first`, `first + count`) as fit, in order.
+    /// @return The number of pushed messages.
+    size_type try_push(const value_type* first, size_type count) noexcept;
+
+// Consumer
+
+    /// @brief Pops the oldest message into `out`.
+    /// @return `false` if the ring is empty.
+    bool try_pop(value_type& out) noexcept;
+
+    /// @brief Pops at most `count` messages into [`out`, `out + count`).
+    /// @return The number of popped messages.
+    size_type try_pop(value_type* out, size_type count) noexcept;
+
+private:
+    shm_ring(layout* memory, size_type mapped) noexcept;
+
+    static layout* initialize(void* memory) noexcept;
+    static layout* check(void* memory);
+
+    static void write(slot& s, const value_type& value) noexcept;
+    static void read(const slot& s, value_type& out) noexcept;
+
+    layout* ring;
+
+    /// @brief The number of bytes to `munmap`, or `0` if the memory isn't ours.
+    size_type mapped;
+
+    // Private copies of the other side's position (SPSC only).
+    alignas(64) std::uint64_t cached_head = 0;
+    alignas(64) std::uint64_t cached_tail = 0;
+};
+
+#define ASH_ring_template template <class T, std::size_t Capacity, ash::ring_mode Mode>
+#define ASH_ring_name ash::shm_ring<T, Capacity, Mode>
+
+ASH_ring_template
+ASH_ring_name ASH_ring_name::create(const char* name, mode_t permissions) {
+    int fd = ::shm_open(name, O_CREAT | O_RDWR, permissions);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "shm_open");
+
+    if (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, required_bytes) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "ftruncate");
+    }
+
+    void* memory = ::mmap(nullptr, required_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);
+
+    if (memory == MAP_FAILED)
+        throw std::system_error(error, std::generic_category(), "mmap");
+
+    return shm_ring(initialize(memory), required_bytes);
+}
+
+ASH_ring_template
+ASH_ring_name ASH_ring_name::open(const char* name) {
+    int fd = ::shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "shm_open");
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat");
+    }
+
+    if (static_cast<std::uint64_t>(info.st_size) < required_bytes) {
+        ::close(fd);
+        throw std::runtime_error("ash::shm_ring: The segment is smaller than the ring.");
+    }
+
+    void* memory = ::mmap(nullptr, required_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);
+
+    if (memory == MAP_FAILED)
+        throw std::system_error(error, std::generic_category(), "mmap");
+
+    try {
+        return shm_ring(check(memory), required_bytes);
+    }
+    catch (...) {
+        ::munmap(memory, required_bytes);
+        throw;
+    }
+}
+
+ASH_ring_template
+ASH_ring_name ASH_ring_name::attach(void* memory, size_type bytes, bool initialize_memory) {
+    if (bytes < required_bytes)
+        throw std::runtime_error("ash::shm_ring: The memory is smaller than the ring.");
+
+    return shm_ring(initialize_memory ? initialize(memory) : check(memory), 0);
+}
+
+ASH_ring_template
+void ASH_ring_name::unlink(const char* name) noexcept {
+    ::shm_unlink(name);
+}
+
+ASH_ring_template
+ASH_ring_name::shm_ring(layout* memory, size_type mapped) noexcept : ring(memory), mapped(mapped) {
+    cached_head = ring->head.value.load(std::memory_order_acquire);
+    cached_tail = ring->tail.value.load(std::memory_order_acquire);
+}
+
+ASH_ring_template
+ASH_ring_name::shm_ring(shm_ring&& other) noexcept
+    : ring(other.ring), mapped(other.mapped), cached_head(other.cached_head), cached_tail(other.cached_tail) {
+    other.ring = nullptr;
+    other.mapped = 0;
+}
+
+ASH_ring_template
+ASH_ring_name& ASH_ring_name::operator=(shm_ring&& other) noexcept {
+    if (this != &other) {
+        if (mapped)
+            ::munmap(ring, mapped);
+
+        ring = other.ring;
+        mapped = other.mapped;
+        cached_head = other.cached_head;
+        cached_tail = other.cached_tail;
+
+        other.ring = nullptr;
+        other.mapped = 0;
+    }
+
+    return *this;
+}
+
+ASH_ring_template
+ASH_ring_name::~shm_ring() {
+    if (mapped)
+        ::munmap(ring, mapped);
+}
+
+ASH_ring_template
+typename ASH_ring_name::size_type ASH_ring_name::size() const noexcept {
+    std::uint64_t head = ring->head.value.load(std::memory_order_acquire);
+    std::uint64_t tail = ring->tail.value.load(std::memory_order_acquire);
+
+    // In MPSC mode, `tail` counts claimed slots, which may be ahead of the published ones.
+    return (tail > head) ? static_cast<size_type>(tail - head) : 0;
+}
+
+ASH_ring_template
+bool ASH_ring_name::empty() const noexcept {
+    return size() == 0;
+}
+
+ASH_ring_template
+bool ASH_ring_name::try_push(const value_type& value) noexcept {
+    return try_push(&value, 1) == 1;
+}
+
+ASH_ring_template
+typename ASH_ring_name::size_type ASH_ring_name::try_push(const value_type* first, size_type count) noexcept {
+    std::atomic<std::uint64_t>& tail = ring->tail.value;
+    std::atomic<std::uint64_t>& head = ring->head.value;
+
+    if constexpr (Mode == ring_mode::spsc) {
+        std::uint64_t pos = tail.load(std::memory_order_relaxed);
+
+        if (Capacity - (pos - cached_head) < count)
+            cached_head = head.load(std::memory_order_acquire);
+
+        size_type n = std::min<size_type>(count, Capacity - (pos - cached_head));
+        for (size_type i = 0; i < n; ++i)
+            write(ring->slots[(pos + i) & (Capacity - 1)], first[i]);
+
+        if (n)
+            tail.store(pos + n, std::memory_order_release);
+
+        return n;
+    }
+    else {
+        std::uint64_t pos = tail.load(std::memory_order_relaxed);
+        size_type n;
+
+        // Claims [`pos`, `pos + n`). The consumer frees the slots in order, so the free room
+        // follows from its position.
+        for (;;) {
+            std::uint64_t free = Capacity - (pos - head.load(std::memory_order_acquire));
+            n = std::min<size_type>(count, static_cast<size_type>(free));
+
+            if (n == 0)
+                return 0;
+
+            if (tail.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+                break;
+        }
+
+        for (size_type i = 0; i < n; ++i) {
+            // The acquire load of `head` above makes the consumer's last read of the slot happen
+            // before this write.
+            slot& s = ring->slots[(pos + i) & (Capacity - 1)];
+            write(s, first[i]);
+            s.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+
+        return n;
+    }
+}
+
+ASH_ring_template
+bool ASH_ring_name::try_pop(value_type& out) noexcept {
+    return try_pop(&out, 1) == 1;
+}
+
+ASH_ring_template
+typename ASH_ring_name::size_type ASH_ring_name::try_pop(value_type* out, size_type count) noexcept {
+    std::atomic<std::uint64_t>& tail = ring->tail.value;
+    std::atomic<std::uint64_t>& head = ring->head.value;
+
+    std::uint64_t pos = head.load(std::memory_order_relaxed);
+
+    if constexpr (Mode == ring_mode::spsc) {
+        if (cached_tail - pos < count)
+            cached_tail = tail.load(std::memory_order_acquire);
+
+        size_type n = std::min<size_type>(count, static_cast<size_type>(cached_tail - pos));
+        for (size_type i = 0; i < n; ++i)
+            read(ring->slots[(pos + i) & (Capacity - 1)], out[i]);
+
+        if (n)
+            head.store(pos + n, std::memory_order_release);
+
+        return n;
+    }
+    else {
+        size_type n = 0;
+
+        // Stops at the first slot which isn't published yet, even if later ones are.
+        for (; n < count; ++n) {
+            slot& s = ring->slots[(pos + n) & (Capacity - 1)];
+            if (s.sequence.load(std::memory_order_acquire) != pos + n + 1)
+                break;
+
+            read(s, out[n]);
+            s.sequence.store(pos + n + Capacity, std::memory_order_release);
+        }
+
+        if (n)
+            head.store(pos + n, std::memory_order_release);
+
+        return n;
+    }
+}
+
+ASH_ring_template
+typename ASH_ring_name::layout* ASH_ring_name::initialize(void* memory) noexcept {
+    layout* l = static_cast<layout*>(memory);
+
+    // Hides the ring from `check` while it is being written.
+    new (&l->info.magic) std::atomic<std::uint64_t>(0);
+
+    l->info.version = layout_version;
+    l->info.mode = static_cast<std::uint32_t>(Mode);
+    l->info.capacity = Capacity;
+    l->info.slot_size = sizeof(slot);
+    l->info.char_size = sizeof(char_type);
+    l->info.string_capacity = static_cast<std::uint32_t>(T::capacity());
+
+    new (&l->head.value) std::atomic<std::uint64_t>(0);
+    new (&l->tail.value) std::atomic<std::uint64_t>(0);
+
+    for (std::size_t i = 0; i < Capacity; ++i) {
+        new (&l->slots[i].sequence) std::atomic<std::uint64_t>(i);
+        l->slots[i].size = 0;
+    }
+
+    l->info.magic.store(magic, std::memory_order_release);
+    return l;
+}
+
+ASH_ring_template
+typename ASH_ring_name::layout* ASH_ring_name::check(void* memory) {
+    layout* l = static_cast<layout*>(memory);
+
+    if (l->info.magic.load(std::memory_order_acquire) != magic)
+        throw std::runtime_error("ash::shm_ring: The segment doesn't contain a ring (or it isn't initialized yet).");
+
+    if (l->info.version != layout_version
+        || l->info.mode != static_cast<std::uint32_t>(Mode)
+        || l->info.capacity != Capacity
+        || l->info.slot_size != sizeof(slot)
+        || l->info.char_size != sizeof(char_type)
+        || l->info.string_capacity != T::capacity())
+        throw std::runtime_error("ash::shm_ring: The ring in the segment has a different layout.");
+
+    return l;
+}
+
+ASH_ring_template
+void ASH_ring_name::write(slot& s, const value_type& value) noexcept {
+    s.size = value.size();
+    std::memcpy(s.chars, value.data(), value.size() * sizeof(char_type));
+}
+
+ASH_ring_template
+void ASH_ring_name::read(const slot& s, value_type& out) noexcept {
+    // The size comes from another process, so it is clamped instead of trusted.
+    size_type size = (s.size < T::capacity()) ? static_cast<size_type>(s.size) : T::capacity();
+
+    out.resize_and_overwrite(size, [&s, size](char_type* chars, size_type) {
+        std::memcpy(chars, s.chars, size * sizeof(char_type));
+        return size;
+    });
+}
+
+#undef ASH_ring_template
+#undef ASH_ring_name
+
+#endif // ASH_SHM_RING
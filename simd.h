@@ -0,0 +1,196 @@
+/*
+================================================================================
+  ash/simd.h - Instruction set detection and the small vector kernels shared by
+  the other headers.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    The instruction sets are detected at compile time, and the intrinsics
+    headers are included for the ones that are available. `ash::simd` has the
+    bit helpers (`ctz`, `popcount`, `prefix_xor`), unaligned loads, the
+    64-byte character match (`match_mask64`) and the comparisons of padded
+    buffers (`equal_padded`, `prefix_equal_padded`). Every kernel has a
+    portable fallback.
+
+  Usage:
+    #include "ash/simd.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_SIMD
+      - ASH_SIMD_SSE2 (if SSE2 is available)
+      - ASH_SIMD_SSSE3 (if SSSE3 is available)
+      - ASH_SIMD_PCLMUL (if carry-less multiplication is available)
+
+================================================================================
+*/
+
+#ifndef ASH_SIMD
+#define ASH_SIMD
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Instruction sets are only detected at compile time (e.g. `-msse4.2`, `-mavx2` or
+// `-march=native`). Every kernel has a portable fallback, so the same code works on all
+// targets.
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+/// @def ASH_SIMD_SSE2
+/// @brief Defined if the kernels can use SSE2.
+#define ASH_SIMD_SSE2 1
+#include <emmintrin.h>
+
+#endif
+
+#if defined(__SSSE3__)
+
+/// @def ASH_SIMD_SSSE3
+/// @brief Defined if the kernels can use SSSE3 (`pshufb`).
+#define ASH_SIMD_SSSE3 1
+#include <tmmintrin.h>
+
+#endif
+
+#if defined(__PCLMUL__)
+
+/// @def ASH_SIMD_PCLMUL
+/// @brief Defined if the kernels can use carry-less multiplication.
+#define ASH_SIMD_PCLMUL 1
+#include <wmmintrin.h>
+
+#endif
+
+namespace ash {
+    namespace simd {
+        /// @brief The width of a vector register in bytes. Buffers that are padded to a multiple
+        /// of this can be processed without any tail handling.
+        constexpr std::size_t width = 16;
+
+        /// @brief Rounds `n` up to a multiple of `width`.
+        constexpr std::size_t round_up(std::size_t n) noexcept {
+            return (n + width - 1) / width * width;
+        }
+
+        /// @brief Index of the least significant set bit. `x` must not be `0`.
+        inline unsigned ctz(std::uint64_t x) noexcept {
+            return static_cast<unsigned>(__builtin_ctzll(x));
+        }
+
+        /// @brief Number of set bits.
+        inline unsigned popcount(std::uint64_t x) noexcept {
+            return static_cast<unsigned>(__builtin_popcountll(x));
+        }
+
+        /// @brief Loads 8 bytes from an unaligned address.
+        inline std::uint64_t load8(const void* p) noexcept {
+            std::uint64_t v;
+            std::memcpy(&v, p, 8);
+            return v;
+        }
+
+        /// @brief Bit `i` is set if byte `i` of [`p`, `p + 64`) is equal to `c`.
+        /// @note All the 64 bytes must be readable.
+        inline std::uint64_t match_mask64(const void* p, unsigned char c) noexcept {
+            const unsigned char* bytes = static_cast<const unsigned char*>(p);
+
+#ifdef ASH_SIMD_SSE2
+            __m128i needle = _mm_set1_epi8(static_cast<char>(c));
+            std::uint64_t mask = 0;
+
+            for (std::size_t i = 0; i < 64; i += width) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+                mask |= std::uint64_t(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)))) << i;
+            }
+
+            return mask;
+#else
+            std::uint64_t mask = 0;
+            for (std::size_t i = 0; i < 64; ++i)
+                mask |= std::uint64_t(bytes[i] == c) << i;
+
+            return mask;
+#endif
+        }
+
+        /// @brief Bit `i` of the result is the XOR of bits [`0`, `i`] of `x`. For a mask of quotes,
+        /// this is the mask of the bytes inside quotes (including the opening quotes).
+        inline std::uint64_t prefix_xor(std::uint64_t x) noexcept {
+#ifdef ASH_SIMD_PCLMUL
+            __m128i all_ones = _mm_set1_epi8(-1);
+            __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(x)), all_ones, 0);
+            return static_cast<std::uint64_t>(_mm_cvtsi128_si64(product));
+#else
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+#endif
+        }
+
+        /// @brief Compares [`a`, `a + bytes`) and [`b`, `b + bytes`).
+        /// @param bytes A multiple of `ash::simd::width`.
+        /// @note Both ranges are read completely, there is no early exit. This is what we want
+        /// for short padded rows, where the branch costs more than the loads.
+        inline bool equal_padded(const void* a, const void* b, std::size_t bytes) noexcept {
+            const unsigned char* pa = static_cast<const unsigned char*>(a);
+            const unsigned char* pb = static_cast<const unsigned char*>(b);
+
+#ifdef ASH_SIMD_SSE2
+            __m128i diff = _mm_setzero_si128();
+            for (std::size_t i = 0; i < bytes; i += width) {
+                __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + i));
+                __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i));
+                diff = _mm_or_si128(diff, _mm_xor_si128(va, vb));
+            }
+
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) == 0xFFFF;
+#else
+            std::uint64_t diff = 0;
+            for (std::size_t i = 0; i < bytes; i += 8)
+                diff |= load8(pa + i) ^ load8(pb + i);
+
+            return diff == 0;
+#endif
+        }
+
+        /// @brief Compares the first `bytes` bytes of `a` and `b`.
+        /// @note Both buffers must be readable up to `round_up(bytes)`.
+        inline bool prefix_equal_padded(const void* a, const void* b, std::size_t bytes) noexcept {
+            const unsigned char* pa = static_cast<const unsigned char*>(a);
+            const unsigned char* pb = static_cast<const unsigned char*>(b);
+
+#ifdef ASH_SIMD_SSE2
+            std::size_t i = 0;
+            for (; i + width <= bytes; i += width) {
+                __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + i));
+                __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF)
+                    return false;
+            }
+
+            if (i == bytes)
+                return true;
+
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i));
+            unsigned care = (1u << (bytes - i)) - 1;
+
+            return (~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))) & care) == 0;
+#else
+            return std::memcmp(pa, pb, bytes) == 0;
+#endif
+        }
+    } // namespace simd
+}
+
+#endif // ASH_SIMD
@@ -0,0 +1,360 @@
+/*
+================================================================================
+  ash/static_path.h - Filesystem paths in a fixed buffer.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::static_path<N>` is a `static_string<N>` with the lexical path
+    operations of `std::filesystem::path` (POSIX, '/' separated), without
+    allocating:
+
+    - `join` (and `/=`, `/`) appends in place, with one capacity check.
+    - `filename`, `stem`, `extension` and `parent` are `std::string_view`s
+      into the path; `to_parent`, `remove_filename`, `replace_extension` and
+      `normalize` change it in place.
+    - The path converts to `const char*` for system calls, since the buffer
+      is always null-terminated.
+
+    The semantics follow `std::filesystem::path`, e.g. the filename of
+    "/a/b/" is empty, the extension of ".bashrc" is empty, and `normalize`
+    works like `lexically_normal` ("a/./b/../c//" becomes "a/c/"). The one
+    difference is that a path starting with "//" has the root "/".
+
+  Usage:
+    #include "ash/static_path.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_STATIC_PATH
+
+================================================================================
+*/
+
+#ifndef ASH_STATIC_PATH
+#define ASH_STATIC_PATH
+
+#include <cstring>
+#include <string_view>
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @class static_path
+    /// @brief A path of at most `N` characters.
+    template <std::size_t N>
+    class static_path;
+
+    /// @brief `lhs` joined with `rhs`.
+    /// @exception `std::out_of_range` if the result is longer than `N`.
+    template <std::size_t N>
+    static_path<N> operator/(const static_path<N>& lhs, std::string_view rhs);
+}
+
+template <std::size_t N>
+class ash::static_path : public ash::basic_static_string<char, N> {
+    using base = basic_static_string<char, N>;
+
+public:
+    using typename base::size_type;
+
+    static constexpr char separator = '/';
+
+// Constructors
+
+    static_path() noexcept = default;
+
+    using base::base;
+
+// Conversions
+
+    /// @brief The null-terminated path, for system calls.
+    operator const char*() const noexcept;
+
+    std::string_view view() const noexcept;
+
+// Operations
+
+    bool is_absolute() const noexcept;
+
+    /// @brief The part after the last separator ("" if the path ends with one).
+    std::string_view filename() const noexcept;
+
+    /// @brief The filename without its extension.
+    std::string_view stem() const noexcept;
+
+    /// @brief The filename from its last '.' (e.g. ".gz"), or "" if it has none. The '.' of
+    /// ".bashrc", "." and ".." is not an extension.
+    std::string_view extension() const noexcept;
+
+    /// @brief The path without its filename and the separators before it ("/" stays "/").
+    std::string_view parent() const noexcept;
+
+// Modifiers
+
+    /// @brief Appends a separator (unless the path is empty or ends with one) and `part`. If `part`
+    /// is absolute, it replaces the path.
+    /// @exception `std::out_of_range` if the result is longer than `N`.
+    static_path& join(std::string_view part);
+
+    /// @brief Same as `join(part)`.
+    static_path& operator/=(std::string_view part);
+
+    /// @brief Replaces the path with `parent()`.
+    static_path& to_parent() noexcept;
+
+    /// @brief Removes the filename, and keeps the separator before it.
+    static_path& remove_filename() noexcept;
+
+    /// @brief Replaces the extension with `extension` (which may or may not start with '.'), or
+    /// removes it if `extension` is empty.
+    /// @exception `std::out_of_range` if the result is longer than `N`.
+    static_path& replace_extension(std::string_view extension = {});
+
+    /// @brief Removes "." components, resolves ".." components lexically, and merges repeated
+    /// separators, like `std::filesystem::path::lexically_normal`. Never makes the path longer,
+    /// except that an empty result becomes ".".
+    static_path& normalize() noexcept;
+
+private:
+    /// @brief Keeps the first `size` characters.
+    void truncate(size_type size) noexcept;
+
+    /// @brief The position where the filename starts.
+    size_type filename_position() const noexcept;
+
+    /// @brief The position where the extension starts (`size()` if there is none).
+    size_type extension_position() const noexcept;
+};
+
+
+#define ASH_sp_template template <std::size_t N>
+#define ASH_sp_name ash::static_path<N>
+
+ASH_sp_template
+ASH_sp_name::operator const char*() const noexcept {
+    return this->c_str();
+}
+
+ASH_sp_template
+std::string_view ASH_sp_name::view() const noexcept {
+    return std::string_view(this->data(), this->size());
+}
+
+ASH_sp_template
+bool ASH_sp_name::is_absolute() const noexcept {
+    return !this->empty() && (*this)[0] == separator;
+}
+
+ASH_sp_template
+std::string_view ASH_sp_name::filename() const noexcept {
+    return view().substr(filename_position());
+}
+
+ASH_sp_template
+std::string_view ASH_sp_name::stem() const noexcept {
+    size_type begin = filename_position();
+    return view().substr(begin, extension_position() - begin);
+}
+
+ASH_sp_template
+std::string_view ASH_sp_name::extension() const noexcept {
+    return view().substr(extension_position());
+}
+
+ASH_sp_template
+std::string_view ASH_sp_name::parent() const noexcept {
+    size_type end = filename_position();
+
+    // The separators before the filename, but not the root.
+    while (end > 1 && (*this)[end - 1] == separator)
+        --end;
+
+    return view().substr(0, end);
+}
+
+ASH_sp_template
+ASH_sp_name& ASH_sp_name::join(std::string_view part) {
+    if (!part.empty() && part[0] == separator) {
+        ash::throw_if_outside_of_capacity(N, part.size());
+        truncate(0);
+    }
+
+    size_type size = this->size();
+    bool needs_separator = size != 0 && (*this)[size - 1] != separator;
+    size_type total = size + needs_separator + part.size();
+
+    ash::throw_if_outside_of_capacity(N, total);
+
+    this->resize_and_overwrite(total, [&part, size, needs_separator](char* chars, size_type count) {
+        if (needs_separator)
+            chars[size] = separator;
+
+        if (!part.empty())
+            std::memcpy(chars + size + needs_separator, part.data(), part.size());
+        return count;
+    });
+
+    return *this;
+}
+
+ASH_sp_template
+ASH_sp_name& ASH_sp_name::operator/=(std::string_view part) {
+    return join(part);
+}
+
+ASH_sp_template
+ASH_sp_name& ASH_sp_name::to_parent() noexcept {
+    truncate(parent().size());
+    return *this;
+}
+
+ASH_sp_template
+ASH_sp_name& ASH_sp_name::remove_filename() noexcept {
+    truncate(filename_position());
+    return *this;
+}
+
+ASH_sp_template
+ASH_sp_name& ASH_sp_name::replace_extension(std::string_view extension) {
+    size_type begin = extension_position();
+    bool needs_dot = !extension.empty() && extension[0] != '.';
+    size_type total = begin + needs_dot + extension.size();
+
+    ash::throw_if_outside_of_capacity(N, total);
+
+    this->resize_and_overwrite(total, [&extension, begin, needs_dot](char* chars, size_type count) {
+        if (needs_dot)
+            chars[begin] = '.';
+
+        if (!extension.empty())
+            std::memcpy(chars + begin + needs_dot, extension.data(), extension.size());
+        return count;
+    });
+
+    return *this;
+}
+
+ASH_sp_template
+ASH_sp_name& ASH_sp_name::normalize() noexcept {
+    size_type size = this->size();
+    if (size == 0)
+        return *this;
+
+    this->resize_and_overwrite(size, [size](char* chars, size_type) -> size_type {
+        // The output never gets ahead of the input, so it's written over it.
+        size_type root = (chars[0] == separator) ? 1 : 0;
+        size_type out = root;
+        size_type in = root;
+
+        // The start of the last component of the output.
+        auto last_start = [chars, root](size_type end) {
+            size_type start = end;
+            while (start > root && chars[start - 1] != separator)
+                --start;
+
+            return start;
+        };
+
+        auto is_dot_dot = [chars](size_type start, size_type end) {
+            return end - start == 2 && chars[start] == '.' && chars[start + 1] == '.';
+        };
+
+        // `true` if the last component was followed by a separator, or was "." or a resolved "..",
+        // which all leave a trailing separator.
+        bool directory = false;
+
+        while (in < size) {
+            size_type start = in;
+            while (in < size && chars[in] != separator)
+                ++in;
+
+            size_type length = in - start;
+            bool followed_by_separator = in < size;
+            if (followed_by_separator)
+                ++in;
+
+            if (length == 0 || (length == 1 && chars[start] == '.')) {
+                directory = true;
+                continue;
+            }
+
+            if (is_dot_dot(start, start + length)) {
+                size_type previous = last_start(out);
+
+                if (out > root && !is_dot_dot(previous, out)) {
+                    // Removes the last component and its separator.
+                    out = (previous > root) ? previous - 1 : root;
+                    directory = true;
+                    continue;
+                }
+
+                if (root) {
+                    // ".." of the root is the root.
+                    directory = false;
+                    continue;
+                }
+            }
+
+            if (out > root)
+                chars[out++] = separator;
+
+            std::memmove(chars + out, chars + start, length);
+            out += length;
+            directory = followed_by_separator;
+        }
+
+        if (directory && out > root && !is_dot_dot(last_start(out), out))
+            chars[out++] = separator;
+
+        if (out == 0)
+            chars[out++] = '.';
+
+        return out;
+    });
+
+    return *this;
+}
+
+ASH_sp_template
+void ASH_sp_name::truncate(size_type size) noexcept {
+    this->resize_and_overwrite(size, [](char*, size_type count) { return count; });
+}
+
+ASH_sp_template
+typename ASH_sp_name::size_type ASH_sp_name::filename_position() const noexcept {
+    size_type position = this->size();
+    while (position > 0 && (*this)[position - 1] != separator)
+        --position;
+
+    return position;
+}
+
+ASH_sp_template
+typename ASH_sp_name::size_type ASH_sp_name::extension_position() const noexcept {
+    std::string_view name = filename();
+
+    if (name == "." || name == "..")
+        return this->size();
+
+    size_type dot = name.rfind('.');
+    if (dot == std::string_view::npos || dot == 0)
+        return this->size();
+
+    return this->size() - name.size() + dot;
+}
+
+template <std::size_t N>
+ash::static_path<N> ash::operator/(const static_path<N>& lhs, std::string_view rhs) {
+    static_path<N> result(lhs);
+    result.join(rhs);
+    return result;
+}
+
+#undef ASH_sp_template
+#undef ASH_sp_name
+
+#endif // ASH_STATIC_PATH
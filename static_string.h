@@ -30,6 +30,8 @@
 #define ASH_STATIC_STRING
 
 #include <array>
+#include <istream>
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <stdexcept>
@@ -37,6 +39,8 @@
 #include "../ash/type_traits.h"
 #include "../ash/cplusplus_versions_compatibility_macros.h"
 #include "../ash/throw_if.h"
+#include "../ash/hash.h"
+#include "../ash/simd.h"
 
 // These are already included in the above libraries.
 // #include <cstddef>
@@ -142,10 +146,13 @@ namespace ash {
     /// is always known at compile time.
     /// @tparam CharT Character-like type of each element.
     /// @tparam N Capacity.
+    /// @tparam Align Alignment of the buffer in bytes (a power of 2). The buffer is also padded to a
+    /// multiple of `Align` bytes, and the padding is always null, so vector kernels can load the
+    /// whole buffer without handling a tail. The default (`1`) adds no padding.
     /// @note The buffer actually stores the string as null terminated (hence the `N + 1`).
     /// However, This class completely acts as if there is no such thing.
     /// (e.g. `back()` never returns `buffer[N]`.)
-    template <class CharT, std::size_t N>
+    template <class CharT, std::size_t N, std::size_t Align = 1>
     class basic_static_string;
 
     /// @struct static_string
@@ -205,6 +212,30 @@ namespace ash {
     template <std::size_t N>
     using static_u32string = basic_static_string<char32_t, N>;
 
+    /// @struct aligned_static_string
+    /// @brief An `ash::static_string<N>` which is aligned to, and takes a multiple of, `Align` bytes
+    /// (e.g. `16` for SSE loads, or `64` for one cache line per string when `N` is at most `55`).
+    /// @tparam N Capacity.
+    /// @tparam Align Alignment in bytes (a power of 2).
+    template <std::size_t N, std::size_t Align>
+    using aligned_static_string = basic_static_string<char, N, Align>;
+
+    /// @class basic_static_string_view
+    /// @brief A non-owning view of the characters of an `ash::basic_static_string<CharT, N>` (or a
+    /// part of them), returned by `substr`, `prefix` and `suffix` without copying.
+    /// @tparam CharT Character-like type of each element.
+    /// @tparam N Capacity of the viewed string.
+    /// @note Unlike `std::basic_string_view`, the view knows that it lies in a buffer of (at least)
+    /// `N + 1` characters, so `readable_size()` characters can be read from `data()`, even past `size()`.
+    /// Vectorized kernels can read whole blocks of the tail without checking for page boundaries.
+    template <class CharT, std::size_t N>
+    class basic_static_string_view;
+
+    /// @brief A view of an `ash::static_string<N>`.
+    /// @tparam N Capacity of the viewed string.
+    template <std::size_t N>
+    using static_string_view = basic_static_string_view<char, N>;
+
 } // Declaration of `ash::basic_static_string`.
 
 
@@ -221,8 +252,8 @@ namespace ash {
     /// @brief True Type (SFINAE): `T` is the same as `ash::basic_static_string<CharT, N>`.
     /// @tparam T type
     /// @note This is a struct. Use `::value` to access the result. `value` is always `true`.
-    template <typename CharT, std::size_t N>
-    struct is_basic_static_string<basic_static_string<CharT, N>> : std::true_type {};
+    template <typename CharT, std::size_t N, std::size_t Align>
+    struct is_basic_static_string<basic_static_string<CharT, N, Align>> : std::true_type {};
 
 
     template <typename T>
@@ -257,11 +288,13 @@ namespace ash {
 } // Neccessary type traits for `ash::basic_static_string`.
 
 
-template <class CharT, std::size_t N>
+template <class CharT, std::size_t N, std::size_t Align>
 class ash::basic_static_string {
-    template <typename, std::size_t>
+    template <typename, std::size_t, std::size_t>
     friend class basic_static_string; // Friends all the other `basic_static_string`s with other template params.
 
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "ash::basic_static_string: Align must be a power of 2.");
+
 // Nested types
 
 protected:
@@ -277,9 +310,14 @@ protected:
     using array_t = CharT[M];
 #endif
 
+    /// @brief The number of characters in the buffer: at least `N + 1`, as many as make the buffer
+    /// and `__size` together a multiple of `Align` bytes (so `__size` shares the last block).
+    static constexpr std::size_t __buffer_chars =
+        (((N + 1) * sizeof(CharT) + sizeof(std::size_t) + Align - 1) / Align * Align - sizeof(std::size_t)) / sizeof(CharT);
+
 public:
     /// @brief Type of the internal buffer.
-    using buffer_type = array_t<N + 1>;
+    using buffer_type = array_t<__buffer_chars>;
 
 #if __cplusplus >= __cpp17
 
@@ -317,10 +355,17 @@ public:
 
 #endif // __cplusplus >= __cpp17
 
+    /// @brief The type of the views returned by `substr`, `prefix` and `suffix`.
+    using view_type = basic_static_string_view<CharT, N>;
+
+    /// @brief "Until the end of the string", for `substr`.
+    static constexpr size_type npos = size_type(-1);
+
     /// @brief Alias to avoid boilder-plate.
     /// @tparam M The capacity.
-    template <size_type M>
-    using other_t = basic_static_string<CharT, M>;
+    /// @tparam other_Align The alignment. Default: the same as this string.
+    template <size_type M, size_type other_Align = Align>
+    using other_t = basic_static_string<CharT, M, other_Align>;
 
 protected:
 #if __cplusplus >= __cpp17
@@ -338,13 +383,13 @@ protected:
 
 #if __cplusplus >= __cpp20
     /// @brief The underlying buffer.
-    buffer_type buffer;
+    alignas(Align > alignof(CharT) ? Align : alignof(CharT)) buffer_type buffer;
 #elif __cplusplus >= __cpp17
     /// @brief The underlying buffer.
-    buffer_type buffer {};
+    alignas(Align > alignof(CharT) ? Align : alignof(CharT)) buffer_type buffer {};
 #else
     /// @brief The underlying buffer.
-    buffer_type buffer {};
+    alignas(Align > alignof(CharT) ? Align : alignof(CharT)) buffer_type buffer {};
 #endif
 
     /// @brief Size of the string.
@@ -354,7 +399,12 @@ public:
 
 // Constructors
 
+#if __cplusplus >= __cpp20
+    /// @brief Constructs an empty string. The buffer isn't initialized by default, so it's nulled here.
+    constexpr basic_static_string() noexcept;
+#else
     _GLIBCXX14_CONSTEXPR basic_static_string() noexcept = default;
+#endif
 
     /// @brief Constructs a string with `count` copies of character `ch`.
     /// @param count Count of copies
@@ -442,8 +492,8 @@ public:
     /// @exception `std::out_of_range` if `other.size()` is more than `N`.
     /// @note `other.capacity()` can be more or less then `N`, it doesn't matter. Only `other.size()`
     /// should fit into `N`.
-    template <std::size_t other_N>
-    _GLIBCXX14_CONSTEXPR basic_static_string(const other_t<other_N>& other);
+    template <std::size_t other_N, std::size_t other_Align>
+    _GLIBCXX14_CONSTEXPR basic_static_string(const other_t<other_N, other_Align>& other);
 
     /// @brief [Move-] Constructs a string with the contents of other.
     /// @param other Other `basic_static_string` object.
@@ -451,8 +501,8 @@ public:
     /// @note When the move finishes, `other` is in a valid state (`other.size() == 0`).
     /// @note `other.capacity()` can be more or less then `N`, it doesn't matter. Only `other.size()`
     /// should fit into `N`.
-    template <std::size_t other_N>
-    _GLIBCXX14_CONSTEXPR basic_static_string(other_t<other_N>&& other);
+    template <std::size_t other_N, std::size_t other_Align>
+    _GLIBCXX14_CONSTEXPR basic_static_string(other_t<other_N, other_Align>&& other);
 
     /// @brief [Copy-] Constructs a string with the contents of other.
     /// @param other Other `basic_static_string` object.
@@ -471,8 +521,8 @@ public:
     /// @param pos Starting index.
     /// @exception `std::out_of_range` if `pos` is equal or more than `other.size()`.
     /// @exception `std::out_of_range` if `other.size() - pos` is more than `N`.
-    template <std::size_t other_N>
-    _GLIBCXX14_CONSTEXPR basic_static_string(const other_t<other_N>& other, size_type pos);
+    template <std::size_t other_N, std::size_t other_Align>
+    _GLIBCXX14_CONSTEXPR basic_static_string(const other_t<other_N, other_Align>& other, size_type pos);
 
     /// @brief [Move-] Constructs a string with the contents of the range [`other.begin() + pos`, `other.end()`).
     /// @param other Other `basic_static_string` object.
@@ -481,8 +531,8 @@ public:
     /// @exception `std::out_of_range` if `other.size() - pos` is more than `N`.
     /// @note When the move finishes, `other` is in a valid state (`other.size() == 0`).
     /// @note The complexity is *linear* in the size of the string.
-    template <std::size_t other_N>
-    _GLIBCXX14_CONSTEXPR basic_static_string(other_t<other_N>&& other, size_type pos);
+    template <std::size_t other_N, std::size_t other_Align>
+    _GLIBCXX14_CONSTEXPR basic_static_string(other_t<other_N, other_Align>&& other, size_type pos);
 
     /// @brief [Copy-] Constructs a string with the contents of the range 
     /// [`other.begin() + pos`, `other.begin() + pos + count`).
@@ -491,8 +541,8 @@ public:
     /// @param count The number of elements to copy.
     /// @exception `std::out_of_range` if `pos + count - 1` is equal or more than `other.size()`.
     /// @exception `std::out_of_range` if `count` is more than `N`.
-    template <std::size_t other_N>
-    _GLIBCXX14_CONSTEXPR basic_static_string(const other_t<other_N>& other, size_type pos, size_type count);
+    template <std::size_t other_N, std::size_t other_Align>
+    _GLIBCXX14_CONSTEXPR basic_static_string(const other_t<other_N, other_Align>& other, size_type pos, size_type count);
 
     /// @brief [Move-] Constructs a string with the contents of the range 
     /// [`other.begin() + pos`, `other.begin() + pos + count`).
@@ -503,16 +553,155 @@ public:
     /// @exception `std::out_of_range` if `count` is more than `N`.
     /// @note When the move finishes, `other` is in a valid state (`other.size() == 0`).
     /// @note The complexity is *linear* in the size of the string.
-    template <std::size_t other_N>
-    _GLIBCXX14_CONSTEXPR basic_static_string(other_t<other_N>&& other, size_type pos, size_type count);
+    template <std::size_t other_N, std::size_t other_Align>
+    _GLIBCXX14_CONSTEXPR basic_static_string(other_t<other_N, other_Align>&& other, size_type pos, size_type count);
+
+// Assignment
+
+    /// @brief [Copy-] Replaces the contents with a copy of other.
+    /// @param other Other `basic_static_string` object.
+    /// @return `*this`
+    _GLIBCXX14_CONSTEXPR basic_static_string& operator=(const other_t<N>& other);
+
+    /// @brief [Move-] Replaces the contents with those of other.
+    /// @param other Other `basic_static_string` object.
+    /// @return `*this`
+    /// @note When the move finishes, `other` is in a valid state (`other.size() == 0`).
+    /// @note The complexity is *linear* in the size of the string.
+    _GLIBCXX14_CONSTEXPR basic_static_string& operator=(other_t<N>&& other);
+
+    /// @brief [Copy-] Replaces the contents with a copy of other.
+    /// @param other Other `basic_static_string` object.
+    /// @return `*this`
+    /// @exception `std::out_of_range` if `other.size()` is more than `N`.
+    template <std::size_t other_N, std::size_t other_Align>
+    _GLIBCXX14_CONSTEXPR basic_static_string& operator=(const other_t<other_N, other_Align>& other);
+
+// Element access
+
+    /// @brief Accesses the character at `pos`. No bounds checking is performed.
+    /// @param pos Index of the character.
+    /// @return Reference to the requested character.
+    _GLIBCXX14_CONSTEXPR reference operator[](size_type pos) noexcept;
+
+    /// @brief Accesses the character at `pos`. No bounds checking is performed.
+    /// @param pos Index of the character.
+    /// @return Reference to the requested character.
+    constexpr const_reference operator[](size_type pos) const noexcept;
+
+    /// @brief Pointer to the underlying buffer.
+    /// @return Pointer to the first character. [`data()`, `data() + size()`) is always a valid range.
+    _GLIBCXX14_CONSTEXPR pointer data() noexcept;
+
+    /// @brief Pointer to the underlying buffer.
+    /// @return Pointer to the first character. [`data()`, `data() + size()`) is always a valid range.
+    constexpr const_pointer data() const noexcept;
+
+    /// @brief Pointer to the null-terminated underlying buffer.
+    /// @return Pointer to the first character.
+    constexpr const_pointer c_str() const noexcept;
+
+// Iterators
+
+    /// @brief Iterator to the first character.
+    _GLIBCXX14_CONSTEXPR iterator begin() noexcept;
+
+    /// @brief Iterator to the first character.
+    constexpr const_iterator begin() const noexcept;
+
+    /// @brief Iterator to the first character.
+    constexpr const_iterator cbegin() const noexcept;
+
+    /// @brief Iterator to the character following the last character.
+    _GLIBCXX14_CONSTEXPR iterator end() noexcept;
+
+    /// @brief Iterator to the character following the last character.
+    constexpr const_iterator end() const noexcept;
+
+    /// @brief Iterator to the character following the last character.
+    constexpr const_iterator cend() const noexcept;
+
+// Capacity
+
+    /// @brief Checks whether the string is empty.
+    /// @return `size() == 0`
+    constexpr bool empty() const noexcept;
+
+    /// @brief Number of characters in the string.
+    constexpr size_type size() const noexcept;
+
+    /// @brief Number of characters in the string.
+    constexpr size_type length() const noexcept;
+
+    /// @brief The maximum number of characters the string is able to hold.
+    /// @return Always `N`.
+    static constexpr size_type max_size() noexcept;
+
+    /// @brief The number of characters the string has allocated space for.
+    /// @return Always `N`.
+    static constexpr size_type capacity() noexcept;
+
+    /// @brief The number of characters in the buffer (at least `N + 1`). The buffer and the size
+    /// together take a multiple of `Align` bytes. All of them can be read from `data()`, and the ones
+    /// after `size()` are always null.
+    static constexpr size_type buffer_size() noexcept;
+
+// Operations
+
+    /// @brief Lets `op` write the contents directly into the buffer, just like
+    /// `std::basic_string::resize_and_overwrite` (C++23).
+    /// @param count The maximum number of characters `op` may write.
+    /// @param op Called as `op(data(), count)`. Must return the new size, which is at most `count`.
+    /// The first `min(size(), count)` characters are the current contents.
+    /// @exception `std::out_of_range` if `count` is more than `N`, or `op` returns more than `count`.
+    /// @note Everything after the new size is null again afterwards, whatever `op` wrote there.
+    template <class Operation>
+    _GLIBCXX14_CONSTEXPR void resize_and_overwrite(size_type count, Operation op);
+
+    /// @brief Lexicographically compares the string with other, just like
+    /// `std::basic_string::compare`.
+    /// @param other Other `basic_static_string` object. The capacity doesn't matter.
+    /// @return Negative value if `*this` comes before `other`, zero if they are equal and positive
+    /// value if `*this` comes after `other`.
+    template <std::size_t other_N, std::size_t other_Align>
+    _GLIBCXX14_CONSTEXPR int compare(const other_t<other_N, other_Align>& other) const noexcept;
+
+    /// @brief A view of [`pos`, `pos + count`) (or [`pos`, `size()`) if the string is shorter),
+    /// without copying.
+    /// @param pos Index of the first character.
+    /// @param count Maximum number of characters.
+    /// @exception `std::out_of_range` if `pos` is more than `size()`.
+    /// @note Unlike `std::basic_string::substr`, the result is a view. It's invalidated when the
+    /// string is modified or destroyed.
+    _GLIBCXX14_CONSTEXPR view_type substr(size_type pos = 0, size_type count = npos) const;
+
+    /// @brief A view of the first `count` characters (or the whole string if it's shorter).
+    _GLIBCXX14_CONSTEXPR view_type prefix(size_type count) const noexcept;
+
+    /// @brief A view of the last `count` characters (or the whole string if it's shorter).
+    _GLIBCXX14_CONSTEXPR view_type suffix(size_type count) const noexcept;
+
+#if __cplusplus >= __cpp17
+// Conversions
+
+    /// @brief Returns a `std::basic_string_view` over [`data()`, `data() + size()`).
+    constexpr operator sv_type() const noexcept;
+#endif
 };
 
 
 #define ASH_bss_template \
-    template <class CharT, std::size_t N>
+    template <class CharT, std::size_t N, std::size_t Align>
 
 #define ASH_bss_name \
-    ash::basic_static_string<CharT, N>
+    ash::basic_static_string<CharT, N, Align>
+
+#if __cplusplus >= __cpp20
+ASH_bss_template
+constexpr ASH_bss_name::basic_static_string() noexcept {
+    ash::fill_with_value(buffer.begin(), buffer.end(), __default_value__(CharT));
+}
+#endif // >= C++20
 
 ASH_bss_template
 _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(size_type count, CharT ch) {
@@ -639,8 +828,8 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const CharT (&str)[array_
 }
 
 ASH_bss_template
-template <std::size_t other_N>
-_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N>& other) {
+template <std::size_t other_N, std::size_t other_Align>
+_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N, other_Align>& other) {
     ash::throw_if_outside_of_capacity(N, other.__size);
 
     ash::fill_from_iterator(std::begin(buffer), std::begin(other.buffer), other.__size);
@@ -653,8 +842,8 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N>& o
 }
 
 ASH_bss_template
-template <std::size_t other_N>
-_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N>&& other) {
+template <std::size_t other_N, std::size_t other_Align>
+_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N, other_Align>&& other) {
     ash::throw_if_outside_of_capacity(N, other.__size);
 
     auto it = std::begin(buffer);
@@ -664,6 +853,8 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N>&& other)
     }
 
     __size = other.__size;
+    // Keeps everything after `size()` null in `other` too.
+    ash::fill_with_value(std::begin(other.buffer), std::begin(other.buffer) + other.__size, __default_value__(CharT));
     other.__size = 0;
 
     // In C++20 and later we didn't initialize the buffer, so we should fill it here.
@@ -696,6 +887,8 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<N>&& other) {
     }
 
     __size = other.__size;
+    // Keeps everything after `size()` null in `other` too.
+    ash::fill_with_value(std::begin(other.buffer), std::begin(other.buffer) + other.__size, __default_value__(CharT));
     other.__size = 0;
 
     // In C++20 and later we didn't initialize the buffer, so we should fill it here.
@@ -705,8 +898,8 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<N>&& other) {
 }
 
 ASH_bss_template
-template <std::size_t other_N>
-_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N>& other, size_type pos) {
+template <std::size_t other_N, std::size_t other_Align>
+_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N, other_Align>& other, size_type pos) {
     ash::throw_if_outside_of_size(other.__size, pos);
 
     size_type len = other.__size - pos;
@@ -722,20 +915,22 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N>& o
 }
 
 ASH_bss_template
-template <std::size_t other_N>
-_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N>&& other, size_type pos) {
+template <std::size_t other_N, std::size_t other_Align>
+_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N, other_Align>&& other, size_type pos) {
     ash::throw_if_outside_of_size(other.__size, pos);
 
     size_type len = other.__size - pos;
     ash::throw_if_outside_of_capacity(N, len);
 
     auto it = std::begin(buffer);
-    for (size_type i = 0; i < other.__size; ++i) {
+    for (size_type i = 0; i < len; ++i) {
         ash::forward_value_to_iterator(std::move(other.buffer[i + pos]), it);
         ++it;
     }
 
     __size = len;
+    // Keeps everything after `size()` null in `other` too.
+    ash::fill_with_value(std::begin(other.buffer), std::begin(other.buffer) + other.__size, __default_value__(CharT));
     other.__size = 0;
 
     // In C++20 and later we didn't initialize the buffer, so we should fill it here.
@@ -745,8 +940,8 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N>&& other,
 }
 
 ASH_bss_template
-template <std::size_t other_N>
-_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N>& other, size_type pos, size_type count) {
+template <std::size_t other_N, std::size_t other_Align>
+_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N, other_Align>& other, size_type pos, size_type count) {
     ash::throw_if_outside_of_size(other.__size, pos + count - 1);
 
     ash::throw_if_outside_of_capacity(N, count);
@@ -761,8 +956,8 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(const other_t<other_N>& o
 }
 
 ASH_bss_template
-template <std::size_t other_N>
-_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N>&& other, size_type pos, size_type count) {
+template <std::size_t other_N, std::size_t other_Align>
+_GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N, other_Align>&& other, size_type pos, size_type count) {
     ash::throw_if_outside_of_size(other.__size, pos + count - 1);
 
     ash::throw_if_outside_of_capacity(N, count);
@@ -774,6 +969,8 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N>&& other,
     }
 
     __size = count;
+    // Keeps everything after `size()` null in `other` too.
+    ash::fill_with_value(std::begin(other.buffer), std::begin(other.buffer) + other.__size, __default_value__(CharT));
     other.__size = 0;
 
     // In C++20 and later we didn't initialize the buffer, so we should fill it here.
@@ -783,5 +980,747 @@ _GLIBCXX14_CONSTEXPR ASH_bss_name::basic_static_string(other_t<other_N>&& other,
 }
 
 
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR ASH_bss_name& ASH_bss_name::operator=(const other_t<N>& other) {
+    if (this == &other)
+        return *this;
+
+    ash::fill_from_iterator(std::begin(buffer), std::begin(other.buffer), other.__size);
+
+    // Keep everything after the string null, so the buffer looks exactly like a freshly
+    // constructed one.
+    if (other.__size < __size)
+        ash::fill_with_value(std::begin(buffer) + other.__size, std::begin(buffer) + __size, __default_value__(CharT));
+
+    __size = other.__size;
+    return *this;
+}
+
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR ASH_bss_name& ASH_bss_name::operator=(other_t<N>&& other) {
+    if (this == &other)
+        return *this;
+
+    auto it = std::begin(buffer);
+    for (size_type i = 0; i < other.__size; ++i) {
+        ash::forward_value_to_iterator(std::move(other.buffer[i]), it);
+        ++it;
+    }
+
+    if (other.__size < __size)
+        ash::fill_with_value(std::begin(buffer) + other.__size, std::begin(buffer) + __size, __default_value__(CharT));
+
+    __size = other.__size;
+    // Keeps everything after `size()` null in `other` too.
+    ash::fill_with_value(std::begin(other.buffer), std::begin(other.buffer) + other.__size, __default_value__(CharT));
+    other.__size = 0;
+
+    return *this;
+}
+
+ASH_bss_template
+template <std::size_t other_N, std::size_t other_Align>
+_GLIBCXX14_CONSTEXPR ASH_bss_name& ASH_bss_name::operator=(const other_t<other_N, other_Align>& other) {
+    ash::throw_if_outside_of_capacity(N, other.__size);
+
+    ash::fill_from_iterator(std::begin(buffer), std::begin(other.buffer), other.__size);
+
+    if (other.__size < __size)
+        ash::fill_with_value(std::begin(buffer) + other.__size, std::begin(buffer) + __size, __default_value__(CharT));
+
+    __size = other.__size;
+    return *this;
+}
+
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR typename ASH_bss_name::reference ASH_bss_name::operator[](size_type pos) noexcept {
+    return buffer[pos];
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::const_reference ASH_bss_name::operator[](size_type pos) const noexcept {
+    return buffer[pos];
+}
+
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR typename ASH_bss_name::pointer ASH_bss_name::data() noexcept {
+    return &buffer[0];
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::const_pointer ASH_bss_name::data() const noexcept {
+    return &buffer[0];
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::const_pointer ASH_bss_name::c_str() const noexcept {
+    return &buffer[0];
+}
+
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR typename ASH_bss_name::iterator ASH_bss_name::begin() noexcept {
+    return std::begin(buffer);
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::const_iterator ASH_bss_name::begin() const noexcept {
+    return std::begin(buffer);
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::const_iterator ASH_bss_name::cbegin() const noexcept {
+    return std::begin(buffer);
+}
+
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR typename ASH_bss_name::iterator ASH_bss_name::end() noexcept {
+    return std::begin(buffer) + __size;
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::const_iterator ASH_bss_name::end() const noexcept {
+    return std::begin(buffer) + __size;
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::const_iterator ASH_bss_name::cend() const noexcept {
+    return std::begin(buffer) + __size;
+}
+
+ASH_bss_template
+constexpr bool ASH_bss_name::empty() const noexcept {
+    return __size == 0;
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::size_type ASH_bss_name::size() const noexcept {
+    return __size;
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::size_type ASH_bss_name::length() const noexcept {
+    return __size;
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::size_type ASH_bss_name::max_size() noexcept {
+    return N;
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::size_type ASH_bss_name::capacity() noexcept {
+    return N;
+}
+
+ASH_bss_template
+constexpr typename ASH_bss_name::size_type ASH_bss_name::buffer_size() noexcept {
+    return __buffer_chars;
+}
+
+ASH_bss_template
+template <class Operation>
+_GLIBCXX14_CONSTEXPR void ASH_bss_name::resize_and_overwrite(size_type count, Operation op) {
+    ash::throw_if_outside_of_capacity(N, count);
+
+    size_type written = static_cast<size_type>(op(data(), count));
+    ash::throw_if_outside_of_capacity(count, written);
+
+    // `buffer[written]` is nulled even if `written == count` (outside of what `op` could write), so the
+    // string is null-terminated whatever was in the buffer before.
+    size_type dirty = (__size > count) ? __size : count;
+    buffer[written] = __default_value__(CharT);
+    ash::fill_with_value(std::begin(buffer) + written, std::begin(buffer) + dirty, __default_value__(CharT));
+
+    __size = written;
+}
+
+ASH_bss_template
+template <std::size_t other_N, std::size_t other_Align>
+_GLIBCXX14_CONSTEXPR int ASH_bss_name::compare(const other_t<other_N, other_Align>& other) const noexcept {
+    using traits = std::char_traits<CharT>;
+
+    size_type len = (__size < other.__size) ? __size : other.__size;
+
+    if (__builtin_is_constant_evaluated()) {
+        for (size_type i = 0; i < len; ++i) {
+            if (traits::lt(buffer[i], other.buffer[i]))
+                return -1;
+            if (traits::lt(other.buffer[i], buffer[i]))
+                return 1;
+        }
+    }
+    else {
+        int result = traits::compare(&buffer[0], &other.buffer[0], len);
+        if (result != 0)
+            return result;
+    }
+
+    if (__size == other.__size)
+        return 0;
+
+    return (__size < other.__size) ? -1 : 1;
+}
+
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR typename ASH_bss_name::view_type ASH_bss_name::substr(size_type pos, size_type count) const {
+    ash::throw_if_outside_of_capacity(__size, pos);
+
+    size_type rest = __size - pos;
+    return view_type(&buffer[0] + pos, (count < rest) ? count : rest, __buffer_chars - pos);
+}
+
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR typename ASH_bss_name::view_type ASH_bss_name::prefix(size_type count) const noexcept {
+    return view_type(&buffer[0], (count < __size) ? count : __size, __buffer_chars);
+}
+
+ASH_bss_template
+_GLIBCXX14_CONSTEXPR typename ASH_bss_name::view_type ASH_bss_name::suffix(size_type count) const noexcept {
+    size_type pos = (count < __size) ? __size - count : 0;
+    return view_type(&buffer[0] + pos, __size - pos, __buffer_chars - pos);
+}
+
+#if __cplusplus >= __cpp17
+ASH_bss_template
+constexpr ASH_bss_name::operator sv_type() const noexcept {
+    return sv_type(&buffer[0], __size);
+}
+#endif
+
+
+template <class CharT, std::size_t N>
+class ash::basic_static_string_view {
+    template <typename, std::size_t, std::size_t>
+    friend class basic_static_string;
+
+    template <typename, std::size_t>
+    friend class basic_static_string_view;
+
+public:
+// Nested types
+
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using reference = const value_type&;
+    using const_reference = const value_type&;
+
+    using pointer = const value_type*;
+    using const_pointer = const value_type*;
+
+    using iterator = const_pointer;
+    using const_iterator = const_pointer;
+
+    static constexpr size_type npos = size_type(-1);
+
+// Constructors
+
+    /// @brief An empty view of nothing. `readable_size()` is `0`.
+    constexpr basic_static_string_view() noexcept = default;
+
+    /// @brief A view of the whole of `str`.
+    template <std::size_t Align>
+    constexpr basic_static_string_view(const basic_static_string<CharT, N, Align>& str) noexcept;
+
+    /// @brief A view of a string with a smaller capacity. Everything it could read is still
+    /// within the buffer.
+    template <std::size_t other_N, typename = ash::enable_if_t<(other_N < N)>>
+    constexpr basic_static_string_view(const basic_static_string_view<CharT, other_N>& other) noexcept;
+
+// Element access
+
+    /// @brief Accesses the character at `pos`. No bounds checking is performed.
+    constexpr const_reference operator[](size_type pos) const noexcept;
+
+    constexpr const_reference front() const noexcept;
+
+    constexpr const_reference back() const noexcept;
+
+    /// @brief Pointer to the first character. Unlike `basic_static_string::c_str()`, the
+    /// characters are not null-terminated in general (e.g. the result of `prefix`).
+    constexpr const_pointer data() const noexcept;
+
+// Iterators
+
+    constexpr const_iterator begin() const noexcept;
+    constexpr const_iterator cbegin() const noexcept;
+
+    constexpr const_iterator end() const noexcept;
+    constexpr const_iterator cend() const noexcept;
+
+// Capacity
+
+    constexpr bool empty() const noexcept;
+
+    constexpr size_type size() const noexcept;
+
+    constexpr size_type length() const noexcept;
+
+    /// @brief The maximum size of a view of a string with capacity `N`.
+    /// @return Always `N`.
+    static constexpr size_type max_size() noexcept;
+
+    /// @brief The number of characters that can be read from `data()`: the rest of the buffer of
+    /// the viewed string, which is always more than `size()` (unless the view is empty and
+    /// default constructed). The characters after `size()` are unspecified.
+    constexpr size_type readable_size() const noexcept;
+
+// Operations
+
+    /// @brief A view of [`pos`, `pos + count`) of this view (or [`pos`, `size()`)).
+    /// @exception `std::out_of_range` if `pos` is more than `size()`.
+    _GLIBCXX14_CONSTEXPR basic_static_string_view substr(size_type pos = 0, size_type count = npos) const;
+
+    /// @brief A view of the first `count` characters (or the whole view if it's shorter).
+    _GLIBCXX14_CONSTEXPR basic_static_string_view prefix(size_type count) const noexcept;
+
+    /// @brief A view of the last `count` characters (or the whole view if it's shorter).
+    _GLIBCXX14_CONSTEXPR basic_static_string_view suffix(size_type count) const noexcept;
+
+    /// @brief Moves the start forward by `count` characters. `count` must be at most `size()`.
+    _GLIBCXX14_CONSTEXPR void remove_prefix(size_type count) noexcept;
+
+    /// @brief Moves the end backward by `count` characters. `count` must be at most `size()`.
+    _GLIBCXX14_CONSTEXPR void remove_suffix(size_type count) noexcept;
+
+    /// @brief Lexicographically compares the view with `other`, like `basic_static_string::compare`.
+    template <std::size_t other_N>
+    _GLIBCXX14_CONSTEXPR int compare(const basic_static_string_view<CharT, other_N>& other) const noexcept;
+
+#if __cplusplus >= __cpp17
+// Conversions
+
+    constexpr operator std::basic_string_view<CharT>() const noexcept;
+#endif
+
+private:
+    constexpr basic_static_string_view(const_pointer first, size_type count, size_type readable) noexcept;
+
+    const_pointer __first = nullptr;
+    size_type __size = 0;
+    size_type __readable = 0;
+};
+
+
+#define ASH_bssv_template \
+    template <class CharT, std::size_t N>
+
+#define ASH_bssv_name \
+    ash::basic_static_string_view<CharT, N>
+
+ASH_bssv_template
+template <std::size_t Align>
+constexpr ASH_bssv_name::basic_static_string_view(const basic_static_string<CharT, N, Align>& str) noexcept
+    : __first(str.data()), __size(str.size()), __readable(str.buffer_size()) {}
+
+ASH_bssv_template
+template <std::size_t other_N, typename>
+constexpr ASH_bssv_name::basic_static_string_view(const basic_static_string_view<CharT, other_N>& other) noexcept
+    : __first(other.__first), __size(other.__size), __readable(other.__readable) {}
+
+ASH_bssv_template
+constexpr ASH_bssv_name::basic_static_string_view(const_pointer first, size_type count, size_type readable) noexcept
+    : __first(first), __size(count), __readable(readable) {}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::const_reference ASH_bssv_name::operator[](size_type pos) const noexcept {
+    return __first[pos];
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::const_reference ASH_bssv_name::front() const noexcept {
+    return __first[0];
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::const_reference ASH_bssv_name::back() const noexcept {
+    return __first[__size - 1];
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::const_pointer ASH_bssv_name::data() const noexcept {
+    return __first;
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::const_iterator ASH_bssv_name::begin() const noexcept {
+    return __first;
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::const_iterator ASH_bssv_name::cbegin() const noexcept {
+    return __first;
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::const_iterator ASH_bssv_name::end() const noexcept {
+    return __first + __size;
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::const_iterator ASH_bssv_name::cend() const noexcept {
+    return __first + __size;
+}
+
+ASH_bssv_template
+constexpr bool ASH_bssv_name::empty() const noexcept {
+    return __size == 0;
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::size_type ASH_bssv_name::size() const noexcept {
+    return __size;
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::size_type ASH_bssv_name::length() const noexcept {
+    return __size;
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::size_type ASH_bssv_name::max_size() noexcept {
+    return N;
+}
+
+ASH_bssv_template
+constexpr typename ASH_bssv_name::size_type ASH_bssv_name::readable_size() const noexcept {
+    return __readable;
+}
+
+ASH_bssv_template
+_GLIBCXX14_CONSTEXPR ASH_bssv_name ASH_bssv_name::substr(size_type pos, size_type count) const {
+    ash::throw_if_outside_of_capacity(__size, pos);
+
+    size_type rest = __size - pos;
+    return basic_static_string_view(__first + pos, (count < rest) ? count : rest, __readable - pos);
+}
+
+ASH_bssv_template
+_GLIBCXX14_CONSTEXPR ASH_bssv_name ASH_bssv_name::prefix(size_type count) const noexcept {
+    return basic_static_string_view(__first, (count < __size) ? count : __size, __readable);
+}
+
+ASH_bssv_template
+_GLIBCXX14_CONSTEXPR ASH_bssv_name ASH_bssv_name::suffix(size_type count) const noexcept {
+    size_type pos = (count < __size) ? __size - count : 0;
+    return basic_static_string_view(__first + pos, __size - pos, __readable - pos);
+}
+
+ASH_bssv_template
+_GLIBCXX14_CONSTEXPR void ASH_bssv_name::remove_prefix(size_type count) noexcept {
+    __first += count;
+    __size -= count;
+    __readable -= count;
+}
+
+ASH_bssv_template
+_GLIBCXX14_CONSTEXPR void ASH_bssv_name::remove_suffix(size_type count) noexcept {
+    __size -= count;
+}
+
+ASH_bssv_template
+template <std::size_t other_N>
+_GLIBCXX14_CONSTEXPR int ASH_bssv_name::compare(const basic_static_string_view<CharT, other_N>& other) const noexcept {
+    using traits = std::char_traits<CharT>;
+
+    size_type len = (__size < other.__size) ? __size : other.__size;
+
+    if (__builtin_is_constant_evaluated()) {
+        for (size_type i = 0; i < len; ++i) {
+            if (traits::lt(__first[i], other.__first[i]))
+                return -1;
+            if (traits::lt(other.__first[i], __first[i]))
+                return 1;
+        }
+    }
+    else if (len != 0) {
+        int result = traits::compare(__first, other.__first, len);
+        if (result != 0)
+            return result;
+    }
+
+    if (__size == other.__size)
+        return 0;
+
+    return (__size < other.__size) ? -1 : 1;
+}
+
+#if __cplusplus >= __cpp17
+ASH_bssv_template
+constexpr ASH_bssv_name::operator std::basic_string_view<CharT>() const noexcept {
+    return std::basic_string_view<CharT>(__first, __size);
+}
+#endif
+
+// Comparison operators
+
+namespace ash {
+    /// @brief Checks if the two strings have the same contents. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+    _GLIBCXX14_CONSTEXPR bool operator==(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept;
+
+    /// @brief Checks if the two strings don't have the same contents. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+    _GLIBCXX14_CONSTEXPR bool operator!=(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept;
+
+    /// @brief Lexicographically compares the two strings. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+    _GLIBCXX14_CONSTEXPR bool operator<(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept;
+
+    /// @brief Lexicographically compares the two strings. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+    _GLIBCXX14_CONSTEXPR bool operator<=(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept;
+
+    /// @brief Lexicographically compares the two strings. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+    _GLIBCXX14_CONSTEXPR bool operator>(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept;
+
+    /// @brief Lexicographically compares the two strings. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+    _GLIBCXX14_CONSTEXPR bool operator>=(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept;
+} // Comparison operators
+
+template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+_GLIBCXX14_CONSTEXPR bool ash::operator==(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept {
+    using aligned_t = basic_static_string<CharT, N, A>;
+
+    // Same padded strings: everything after `size()` is null and the size fills the rest of the last
+    // block, so the whole objects (sizes included) are compared with full-width loads and no branches.
+    if_constexpr (N == M && A == B && A >= ash::simd::width && std::is_integral<CharT>::value
+                  && sizeof(aligned_t) == aligned_t::buffer_size() * sizeof(CharT) + sizeof(std::size_t)) {
+        if (!__builtin_is_constant_evaluated())
+            return ash::simd::equal_padded(&lhs, &rhs, sizeof(aligned_t));
+    }
+
+    return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+}
+
+template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+_GLIBCXX14_CONSTEXPR bool ash::operator!=(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+_GLIBCXX14_CONSTEXPR bool ash::operator<(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept {
+    return lhs.compare(rhs) < 0;
+}
+
+template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+_GLIBCXX14_CONSTEXPR bool ash::operator<=(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept {
+    return lhs.compare(rhs) <= 0;
+}
+
+template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+_GLIBCXX14_CONSTEXPR bool ash::operator>(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept {
+    return lhs.compare(rhs) > 0;
+}
+
+template <class CharT, std::size_t N, std::size_t M, std::size_t A, std::size_t B>
+_GLIBCXX14_CONSTEXPR bool ash::operator>=(const basic_static_string<CharT, N, A>& lhs, const basic_static_string<CharT, M, B>& rhs) noexcept {
+    return lhs.compare(rhs) >= 0;
+}
+
+namespace ash {
+    /// @brief Checks if the two views have the same contents. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M>
+    _GLIBCXX14_CONSTEXPR bool operator==(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept;
+
+    /// @brief Checks if the two views don't have the same contents. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M>
+    _GLIBCXX14_CONSTEXPR bool operator!=(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept;
+
+    /// @brief Lexicographically compares the two views. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M>
+    _GLIBCXX14_CONSTEXPR bool operator<(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept;
+
+    /// @brief Lexicographically compares the two views. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M>
+    _GLIBCXX14_CONSTEXPR bool operator<=(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept;
+
+    /// @brief Lexicographically compares the two views. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M>
+    _GLIBCXX14_CONSTEXPR bool operator>(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept;
+
+    /// @brief Lexicographically compares the two views. The capacities don't matter.
+    template <class CharT, std::size_t N, std::size_t M>
+    _GLIBCXX14_CONSTEXPR bool operator>=(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept;
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+_GLIBCXX14_CONSTEXPR bool ash::operator==(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept {
+    return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+_GLIBCXX14_CONSTEXPR bool ash::operator!=(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+_GLIBCXX14_CONSTEXPR bool ash::operator<(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept {
+    return lhs.compare(rhs) < 0;
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+_GLIBCXX14_CONSTEXPR bool ash::operator<=(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept {
+    return lhs.compare(rhs) <= 0;
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+_GLIBCXX14_CONSTEXPR bool ash::operator>(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept {
+    return lhs.compare(rhs) > 0;
+}
+
+template <class CharT, std::size_t N, std::size_t M>
+_GLIBCXX14_CONSTEXPR bool ash::operator>=(const basic_static_string_view<CharT, N>& lhs, const basic_static_string_view<CharT, M>& rhs) noexcept {
+    return lhs.compare(rhs) >= 0;
+}
+
+// Stream operators
+
+namespace ash {
+    /// @brief Writes `str` into `os`, just like `operator<<` of `std::basic_string`. The characters are
+    /// written straight from the buffer, `os.width()` and `os.fill()` are respected.
+    template <class CharT, std::size_t N, std::size_t Align, class Traits>
+    std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const basic_static_string<CharT, N, Align>& str);
+
+    /// @brief Reads a word (up to the next whitespace) into `str`, just like `operator>>` of
+    /// `std::basic_string`.
+    /// @note At most `N` characters are read, or `is.width()` if it's positive and smaller. The
+    /// rest of a longer word stays in the stream, like reading into a `char` array with `std::setw`.
+    /// Sets `failbit` if no characters could be read.
+    template <class CharT, std::size_t N, std::size_t Align, class Traits>
+    std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, basic_static_string<CharT, N, Align>& str);
+} // Stream operators
+
+template <class CharT, std::size_t N, std::size_t Align, class Traits>
+std::basic_ostream<CharT, Traits>& ash::operator<<(std::basic_ostream<CharT, Traits>& os, const basic_static_string<CharT, N, Align>& str) {
+    typename std::basic_ostream<CharT, Traits>::sentry guard(os);
+    if (!guard)
+        return os;
+
+    auto size = static_cast<std::streamsize>(str.size());
+    std::streamsize padding = (os.width() > size) ? os.width() - size : 0;
+    bool left = (os.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+
+    std::basic_streambuf<CharT, Traits>* buf = os.rdbuf();
+    bool ok = true;
+
+    auto pad = [&]() {
+        for (std::streamsize i = 0; ok && i < padding; ++i)
+            ok = !Traits::eq_int_type(buf->sputc(os.fill()), Traits::eof());
+    };
+
+    if (!left)
+        pad();
+
+    if (ok)
+        ok = (buf->sputn(str.data(), size) == size);
+
+    if (left)
+        pad();
+
+    os.width(0);
+
+    if (!ok)
+        os.setstate(std::ios_base::badbit);
+
+    return os;
+}
+
+template <class CharT, std::size_t N, std::size_t Align, class Traits>
+std::basic_istream<CharT, Traits>& ash::operator>>(std::basic_istream<CharT, Traits>& is, basic_static_string<CharT, N, Align>& str) {
+    // Skips the leading whitespace.
+    typename std::basic_istream<CharT, Traits>::sentry guard(is);
+    if (!guard)
+        return is;
+
+    std::streamsize width = is.width();
+    std::size_t limit = (width > 0 && static_cast<std::size_t>(width) < N) ? static_cast<std::size_t>(width) : N;
+
+    const std::ctype<CharT>& ctype = std::use_facet<std::ctype<CharT>>(is.getloc());
+    std::basic_streambuf<CharT, Traits>* buf = is.rdbuf();
+    std::ios_base::iostate state = std::ios_base::goodbit;
+
+    str.resize_and_overwrite(limit, [&](CharT* out, std::size_t count) {
+        std::size_t n = 0;
+
+        for (typename Traits::int_type c = buf->sgetc();; c = buf->snextc()) {
+            if (Traits::eq_int_type(c, Traits::eof())) {
+                state |= std::ios_base::eofbit;
+                break;
+            }
+
+            if (n == count || ctype.is(std::ctype_base::space, Traits::to_char_type(c)))
+                break;
+
+            out[n++] = Traits::to_char_type(c);
+        }
+
+        return n;
+    });
+
+    is.width(0);
+
+    if (str.empty())
+        state |= std::ios_base::failbit;
+
+    is.setstate(state);
+    return is;
+}
+
+// Hash support
+
+namespace std {
+    /// @brief Hash support for `ash::basic_static_string`. Only [`data()`, `data() + size()`)
+    /// is hashed, so equal strings with different capacities have the same hash.
+    template <class CharT, std::size_t N, std::size_t Align>
+    struct hash<ash::basic_static_string<CharT, N, Align>> {
+        std::size_t operator()(const ash::basic_static_string<CharT, N, Align>& str) const noexcept {
+            return ash::hash_bytes(str.data(), str.size() * sizeof(CharT));
+        }
+    };
+
+    /// @brief Hash support for `ash::basic_static_string_view`, the same as the hash of the
+    /// viewed characters as a `basic_static_string`.
+    template <class CharT, std::size_t N>
+    struct hash<ash::basic_static_string_view<CharT, N>> {
+        std::size_t operator()(const ash::basic_static_string_view<CharT, N>& view) const noexcept {
+            return ash::hash_bytes(view.data(), view.size() * sizeof(CharT));
+        }
+    };
+} // Hash support
+
+// The layout and the null padding the padded comparison relies on.
+static_assert(sizeof(ash::aligned_static_string<20, 64>) == 64, "ash::aligned_static_string: expected one cache line.");
+static_assert(sizeof(ash::aligned_static_string<55, 64>) == 64, "ash::aligned_static_string: expected one cache line.");
+
+#if __cplusplus >= __cpp20
+static_assert([] {
+    ash::aligned_static_string<5, 16> b("hi");
+    ash::aligned_static_string<5, 16> c;
+    c = b;
+
+    for (std::size_t i = c.size(); i < c.buffer_size(); ++i)
+        if (c.data()[i] != '\0')
+            return false;
+
+    return c == b;
+}(), "ash::basic_static_string: the buffer after `size()` must be null.");
+
+static_assert([] {
+    ash::static_string<8> s;
+    s.resize_and_overwrite(3, [](char* chars, std::size_t count) {
+        chars[0] = 'a';
+        chars[1] = 'b';
+        chars[2] = 'c';
+        return count;
+    });
+
+    return s.c_str()[3] == '\0';
+}(), "ash::basic_static_string::resize_and_overwrite: the result must be null-terminated.");
+#endif // >= C++20
+
 
 #endif // ASH_STATIC_STRING
\ No newline at end of file
@@ -0,0 +1,444 @@
+/*
+================================================================================
+  ash/static_string_algorithm.h - Algorithms specialized for collections of
+  `ash::basic_static_string`.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    Generic algorithms (like `std::sort`) know nothing about the strings they
+    are working on, so every comparison walks the characters one by one. The
+    algorithms in this file exploit the fact that the capacity of a
+    `basic_static_string` is known at compile time.
+
+    - `ash::sort`: MSD radix sort over a big-endian key made of the first 8
+      bytes of every string. The full comparison is only used to break ties
+      between strings whose first 8 bytes are the same.
+
+    In C++17 and later, the following modify a string in place:
+
+    - `ash::trim`, `ash::ltrim`, `ash::rtrim`: remove the characters of a
+      `char_class` (whitespace by default) from both ends, the start or the
+      end. The ends are found with the vectorized `char_class` kernels.
+    - `ash::strip`: removes every character of a `char_class`, moving the
+      runs between them with `memmove`.
+    - `ash::replace_all`: counts the occurrences first, so that the capacity
+      is checked once (and the string is left unchanged if it doesn't fit),
+      then moves the runs between them in bulk in a single pass.
+
+  Usage:
+    #include "ash/static_string_algorithm.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_STATIC_STRING_ALGORITHM
+
+================================================================================
+*/
+
+#ifndef ASH_STATIC_STRING_ALGORITHM
+#define ASH_STATIC_STRING_ALGORITHM
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+#include "../ash/static_string.h"
+#include "../ash/type_traits.h"
+#include "../ash/cplusplus_versions_compatibility_macros.h"
+
+#if __cplusplus >= __cpp17
+#include <string_view>
+#include "../ash/char_class.h"
+#include "../ash/throw_if.h"
+#endif
+
+namespace ash {
+    /// @brief Sorts a vector of strings in ascending order using MSD radix sort.
+    /// @param vec The strings to sort.
+    /// @note The order is the same as `operator<` (and `std::sort`), but the sort is not stable.
+    /// Since equal strings are indistinguishable, this doesn't make any difference.
+    /// @note Needs `O(vec.size())` additional memory.
+    template <class CharT, std::size_t N, std::size_t Align, class Allocator>
+    void sort(std::vector<basic_static_string<CharT, N, Align>, Allocator>& vec);
+
+    /// @brief Sorts an array of strings in ascending order using MSD radix sort.
+    /// @param arr The strings to sort.
+    /// @note The order is the same as `operator<` (and `std::sort`), but the sort is not stable.
+    /// Since equal strings are indistinguishable, this doesn't make any difference.
+    /// @note Needs `O(arr.size())` additional memory.
+    template <class CharT, std::size_t N, std::size_t Align, std::size_t arr_N>
+    void sort(std::array<basic_static_string<CharT, N, Align>, arr_N>& arr);
+
+    /// @brief Sorts the strings in the range [`first`, `last`) in ascending order using MSD radix sort.
+    /// @param first Starting iterator (including).
+    /// @param last Ending iterator (excluding).
+    /// @note This function won't participate in overload resolution if the value type of
+    /// `RandomIt` is not an `ash::basic_static_string`.
+    /// @note Needs `O(last - first)` additional memory.
+    template <
+        class RandomIt,
+        typename = ash::enable_if_is_basic_static_string_t<
+            typename std::iterator_traits<RandomIt>::value_type
+        >
+    >
+    void sort(RandomIt first, RandomIt last);
+
+#if __cplusplus >= __cpp17
+    /// @brief Removes the leading and trailing characters of `str` that are in `cls`.
+    /// @return `str`
+    /// @note `char` strings only, since `char_class` is a set of bytes.
+    template <std::size_t N, std::size_t Align>
+    basic_static_string<char, N, Align>& trim(basic_static_string<char, N, Align>& str, const char_class& cls = char_classes::whitespace) noexcept;
+
+    /// @brief Removes the leading characters of `str` that are in `cls`.
+    /// @return `str`
+    /// @note `char` strings only, since `char_class` is a set of bytes.
+    template <std::size_t N, std::size_t Align>
+    basic_static_string<char, N, Align>& ltrim(basic_static_string<char, N, Align>& str, const char_class& cls = char_classes::whitespace) noexcept;
+
+    /// @brief Removes the trailing characters of `str` that are in `cls`.
+    /// @return `str`
+    /// @note `char` strings only, since `char_class` is a set of bytes.
+    template <std::size_t N, std::size_t Align>
+    basic_static_string<char, N, Align>& rtrim(basic_static_string<char, N, Align>& str, const char_class& cls = char_classes::whitespace) noexcept;
+
+    /// @brief Removes every character of `str` that is in `cls`.
+    /// @return `str`
+    /// @note `char` strings only, since `char_class` is a set of bytes.
+    template <std::size_t N, std::size_t Align>
+    basic_static_string<char, N, Align>& strip(basic_static_string<char, N, Align>& str, const char_class& cls) noexcept;
+
+    /// @brief Replaces the occurrences of `from` in `str` (from left to right, without overlaps)
+    /// with `to`. Nothing is replaced if `from` is empty.
+    /// @return The number of replacements.
+    /// @exception `std::out_of_range` if the result is longer than `N`. `str` is unchanged then.
+    template <class CharT, std::size_t N, std::size_t Align>
+    std::size_t replace_all(basic_static_string<CharT, N, Align>& str,
+                            std::basic_string_view<typename basic_static_string<CharT, N, Align>::value_type> from,
+                            std::basic_string_view<typename basic_static_string<CharT, N, Align>::value_type> to);
+#endif
+}
+
+namespace ash {
+    namespace __radix_sort_details {
+        /// @brief One element of the radix sort. Instead of moving the strings themselves
+        /// (which are `N + 1` characters each), we sort these and move every string only once
+        /// at the end.
+        struct entry {
+            std::uint64_t key;
+            std::size_t index;
+        };
+
+        /// @brief Below this size, buckets are sorted with insertion sort.
+        constexpr std::size_t insertion_sort_threshold = 32;
+
+        /// @brief Maps a character to an unsigned number with the same order as
+        /// `std::char_traits<CharT>::lt`.
+        template <class CharT>
+        constexpr std::uint64_t digit(CharT c) noexcept {
+            using unsigned_t = typename std::make_unsigned<CharT>::type;
+
+            // `std::char_traits<char>` compares as `unsigned char`, but the wider character
+            // types are compared as the type itself.
+            return (std::is_signed<CharT>::value && sizeof(CharT) > 1)
+                ? static_cast<std::uint64_t>(static_cast<unsigned_t>(c) ^ (unsigned_t(1) << (sizeof(CharT) * 8 - 1)))
+                : static_cast<std::uint64_t>(static_cast<unsigned_t>(c));
+        }
+
+        /// @brief Builds the big-endian key of the first 8 bytes of `str`. Characters past
+        /// `str.size()` are treated as `0`.
+        template <class CharT, std::size_t N, std::size_t Align>
+        std::uint64_t prefix_key(const basic_static_string<CharT, N, Align>& str) noexcept {
+            constexpr std::size_t key_chars = 8 / sizeof(CharT);
+            constexpr std::size_t bits = sizeof(CharT) * 8;
+
+            std::size_t len = (str.size() < key_chars) ? str.size() : key_chars;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            // The buffer holds `buffer_size()` characters (at least `N + 1`), so for `char` strings
+            // with a buffer of 8 or more one unaligned load is enough.
+            if_constexpr (sizeof(CharT) == 1 && basic_static_string<CharT, N, Align>::buffer_size() >= 8) {
+                std::uint64_t word;
+                std::memcpy(&word, str.data(), 8);
+                word = __builtin_bswap64(word);
+                return (len == 0) ? 0 : word & (~std::uint64_t(0) << (64 - 8 * len));
+            }
+#endif
+
+            std::uint64_t key = 0;
+            for (std::size_t i = 0; i < key_chars; ++i) {
+                key = (bits >= 64) ? 0 : (key << bits);
+                if (i < len)
+                    key |= digit(str[i]);
+            }
+
+            return key;
+        }
+
+        /// @brief Orders two entries by their keys and falls back to the full comparison
+        /// only if the keys are equal.
+        template <class RandomIt>
+        bool less(const entry& a, const entry& b, RandomIt strings) {
+            if (a.key != b.key)
+                return a.key < b.key;
+
+            return strings[a.index].compare(strings[b.index]) < 0;
+        }
+
+        template <class RandomIt>
+        void insertion_sort(entry* first, entry* last, RandomIt strings) {
+            for (entry* it = first + 1; it < last; ++it) {
+                entry value = *it;
+                entry* hole = it;
+
+                while (hole != first && less(value, *(hole - 1), strings)) {
+                    *hole = *(hole - 1);
+                    --hole;
+                }
+
+                *hole = value;
+            }
+        }
+
+        /// @brief Sorts [`first`, `last`) on the byte `byte` of the keys (`7` is the most
+        /// significant one), then recurses into every bucket on the next byte.
+        /// @param tmp Scratch space with at least `last - first` elements.
+        template <class RandomIt>
+        void msd_radix_sort(entry* first, entry* last, entry* tmp, int byte, RandomIt strings) {
+            std::size_t count = last - first;
+            std::size_t histogram[256];
+            unsigned shift;
+
+            while (true) {
+                if (count < insertion_sort_threshold) {
+                    insertion_sort(first, last, strings);
+                    return;
+                }
+
+                if (byte < 0) {
+                    // All of the keys are equal, only the full comparison can break the ties.
+                    std::sort(first, last, [strings](const entry& a, const entry& b) {
+                        return strings[a.index].compare(strings[b.index]) < 0;
+                    });
+                    return;
+                }
+
+                std::fill(histogram, histogram + 256, 0);
+                shift = 8 * byte;
+
+                for (entry* it = first; it != last; ++it)
+                    ++histogram[(it->key >> shift) & 0xFF];
+
+                // Long common prefixes are usual (e.g. symbols of the same exchange). If all
+                // keys have the same digit, there is nothing to scatter.
+                if (histogram[(first->key >> shift) & 0xFF] != count)
+                    break;
+
+                --byte;
+            }
+
+            std::size_t offsets[256];
+
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < 256; ++i) {
+                offsets[i] = sum;
+                sum += histogram[i];
+            }
+
+            for (entry* it = first; it != last; ++it)
+                tmp[offsets[(it->key >> shift) & 0xFF]++] = *it;
+
+            std::memcpy(first, tmp, count * sizeof(entry));
+
+            entry* bucket = first;
+            for (std::size_t i = 0; i < 256; ++i) {
+                if (histogram[i] > 1)
+                    msd_radix_sort(bucket, bucket + histogram[i], tmp, byte - 1, strings);
+
+                bucket += histogram[i];
+            }
+        }
+
+        /// @brief Computes the sorted order of [`first`, `last`) as a list of indices.
+        template <class RandomIt>
+        std::vector<entry> sorted_entries(RandomIt first, RandomIt last) {
+            std::size_t count = last - first;
+
+            std::vector<entry> entries(count);
+            for (std::size_t i = 0; i < count; ++i)
+                entries[i] = entry { prefix_key(first[i]), i };
+
+            std::vector<entry> tmp(count);
+            if (count > 1)
+                msd_radix_sort(entries.data(), entries.data() + count, tmp.data(), 7, first);
+
+            return entries;
+        }
+    } // namespace __radix_sort_details
+}
+
+template <class CharT, std::size_t N, std::size_t Align, class Allocator>
+void ash::sort(std::vector<basic_static_string<CharT, N, Align>, Allocator>& vec) {
+    auto entries = __radix_sort_details::sorted_entries(vec.begin(), vec.end());
+
+    std::vector<basic_static_string<CharT, N, Align>, Allocator> sorted(vec.get_allocator());
+    sorted.reserve(vec.size());
+
+    for (const auto& e : entries)
+        sorted.push_back(std::move(vec[e.index]));
+
+    vec.swap(sorted);
+}
+
+template <class CharT, std::size_t N, std::size_t Align, std::size_t arr_N>
+void ash::sort(std::array<basic_static_string<CharT, N, Align>, arr_N>& arr) {
+    ash::sort(arr.begin(), arr.end());
+}
+
+template <class RandomIt, typename>
+void ash::sort(RandomIt first, RandomIt last) {
+    using value_t = typename std::iterator_traits<RandomIt>::value_type;
+
+    auto entries = __radix_sort_details::sorted_entries(first, last);
+
+    std::vector<value_t> sorted;
+    sorted.reserve(entries.size());
+
+    for (const auto& e : entries)
+        sorted.push_back(std::move(first[e.index]));
+
+    std::move(sorted.begin(), sorted.end(), first);
+}
+
+#if __cplusplus >= __cpp17
+
+template <std::size_t N, std::size_t Align>
+ash::basic_static_string<char, N, Align>& ash::trim(basic_static_string<char, N, Align>& str, const char_class& cls) noexcept {
+    return ash::ltrim(ash::rtrim(str, cls), cls);
+}
+
+template <std::size_t N, std::size_t Align>
+ash::basic_static_string<char, N, Align>& ash::ltrim(basic_static_string<char, N, Align>& str, const char_class& cls) noexcept {
+    std::size_t first = ash::find_first_not_in_class(str, cls);
+    if (first == 0)
+        return str;
+
+    // Can't throw, the count is `size()`.
+    str.resize_and_overwrite(str.size(), [first](char* chars, std::size_t count) -> std::size_t {
+        if (first == std::string_view::npos)
+            return 0;
+
+        std::memmove(chars, chars + first, count - first);
+        return count - first;
+    });
+
+    return str;
+}
+
+template <std::size_t N, std::size_t Align>
+ash::basic_static_string<char, N, Align>& ash::rtrim(basic_static_string<char, N, Align>& str, const char_class& cls) noexcept {
+    std::size_t last = ash::find_last_not_in_class(str, cls);
+    std::size_t size = (last == std::string_view::npos) ? 0 : last + 1;
+
+    // Can't throw, the count is `size()`.
+    if (size != str.size())
+        str.resize_and_overwrite(str.size(), [size](char*, std::size_t) { return size; });
+
+    return str;
+}
+
+template <std::size_t N, std::size_t Align>
+ash::basic_static_string<char, N, Align>& ash::strip(basic_static_string<char, N, Align>& str, const char_class& cls) noexcept {
+    std::string_view view = str;
+
+    std::size_t out = ash::find_first_in_class(view, cls);
+    if (out == std::string_view::npos)
+        return str;
+
+    // Can't throw, the count is `size()`.
+    str.resize_and_overwrite(str.size(), [view, out, &cls](char* chars, std::size_t count) mutable {
+        std::size_t in = out;
+
+        while (in < count) {
+            // Skips the run of removed characters, then keeps the run up to the next one.
+            std::size_t kept = ash::find_first_not_in_class(view.substr(in), cls);
+            if (kept == std::string_view::npos)
+                break;
+
+            in += kept;
+
+            std::size_t removed = ash::find_first_in_class(view.substr(in), cls);
+            std::size_t run = (removed == std::string_view::npos) ? count - in : removed;
+
+            std::memmove(chars + out, chars + in, run);
+            out += run;
+            in += run;
+        }
+
+        return out;
+    });
+
+    return str;
+}
+
+template <class CharT, std::size_t N, std::size_t Align>
+std::size_t ash::replace_all(basic_static_string<CharT, N, Align>& str,
+                             std::basic_string_view<typename basic_static_string<CharT, N, Align>::value_type> from,
+                             std::basic_string_view<typename basic_static_string<CharT, N, Align>::value_type> to) {
+    using sv_type = std::basic_string_view<CharT>;
+    using traits = std::char_traits<CharT>;
+
+    if (from.empty())
+        return 0;
+
+    sv_type view = str;
+
+    // The counting pass, so that the capacity is only checked once.
+    std::size_t occurrences = 0;
+    for (std::size_t i = view.find(from); i != sv_type::npos; i = view.find(from, i + from.size()))
+        ++occurrences;
+
+    if (occurrences == 0)
+        return 0;
+
+    std::size_t size = str.size();
+    std::size_t total = size - occurrences * from.size() + occurrences * to.size();
+    ash::throw_if_outside_of_capacity(N, total);
+
+    str.resize_and_overwrite(size > total ? size : total, [&](CharT* chars, std::size_t) {
+        // When the string grows, the input is first moved to the end of the result. Every
+        // replacement grows the output by the same amount, so the output never catches up with
+        // the input, and one forward pass is enough either way.
+        std::size_t shift = total - (size < total ? size : total);
+        if (shift != 0)
+            traits::move(chars + shift, chars, size);
+
+        sv_type in(chars + shift, size);
+        std::size_t out = 0;
+        std::size_t i = 0;
+
+        for (std::size_t match = in.find(from); match != sv_type::npos; match = in.find(from, i)) {
+            traits::move(chars + out, chars + shift + i, match - i);
+            out += match - i;
+
+            traits::copy(chars + out, to.data(), to.size());
+            out += to.size();
+            i = match + from.size();
+        }
+
+        traits::move(chars + out, chars + shift + i, size - i);
+        return total;
+    });
+
+    return occurrences;
+}
+
+#endif // __cplusplus >= __cpp17
+
+#endif // ASH_STATIC_STRING_ALGORITHM
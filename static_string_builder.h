@@ -0,0 +1,370 @@
+/*
+================================================================================
+  ash/static_string_builder.h - Assembles strings in a fixed buffer, flushing on overflow.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::static_string_builder<N>` appends strings, characters and numbers
+    into a buffer of `N` characters. It never allocates and never throws by
+    itself:
+
+    - Every `append` checks the free space once, then copies (or converts
+      the number) straight into the buffer.
+    - When a fragment doesn't fit, the builder calls its flush callback with
+      what it has, empties itself, and carries on. Fragments larger than the
+      whole buffer are passed to the callback directly.
+    - Without a callback, what doesn't fit is dropped and `truncated()`
+      returns `true`.
+
+    This is meant for log lines and similar output, which are assembled from
+    many small fragments and then written out, e.g.:
+
+      ash::fd_writer out(1);
+      ash::static_string_builder<256> line([&out](std::string_view s) { out.write(s); });
+      line.append("user ").append(id).append(' ').append(elapsed_ms).append("ms\n");
+      line.flush();
+
+  Usage:
+    #include "ash/static_string_builder.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_STATIC_STRING_BUILDER
+
+================================================================================
+*/
+
+#ifndef ASH_STATIC_STRING_BUILDER
+#define ASH_STATIC_STRING_BUILDER
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "../ash/static_string.h"
+
+namespace ash {
+    /// @class basic_static_string_builder
+    /// @brief Assembles a string of at most `N` characters and hands it to `Flush` on overflow.
+    /// @tparam Flush Called with a `std::basic_string_view<CharT>`. Its exceptions pass through.
+    template <class CharT, std::size_t N, class Flush = std::function<void(std::basic_string_view<CharT>)>>
+    class basic_static_string_builder;
+
+    template <std::size_t N, class Flush = std::function<void(std::string_view)>>
+    using static_string_builder = basic_static_string_builder<char, N, Flush>;
+}
+
+template <class CharT, std::size_t N, class Flush>
+class ash::basic_static_string_builder {
+public:
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using sv_type = std::basic_string_view<CharT>;
+
+// Constructors
+
+    /// @brief A builder without a callback, which drops what doesn't fit.
+    basic_static_string_builder() = default;
+
+    /// @brief A builder which calls `flush(content)` when a fragment doesn't fit.
+    explicit basic_static_string_builder(Flush flush) noexcept(std::is_nothrow_move_constructible<Flush>::value);
+
+    /// @note The content is not flushed on destruction, call `flush` for that.
+    ~basic_static_string_builder() = default;
+
+// Capacity
+
+    static constexpr size_type capacity() noexcept { return N; }
+
+    size_type size() const noexcept;
+
+    bool empty() const noexcept;
+
+    /// @brief `true` if anything was dropped (only without a callback) since the last `clear`.
+    bool truncated() const noexcept;
+
+// Element access
+
+    const CharT* data() const noexcept;
+
+    /// @brief The content. It stays valid until the builder is modified.
+    sv_type view() const noexcept;
+
+// Modifiers
+
+    basic_static_string_builder& append(sv_type str);
+
+    /// @brief Appends a null-terminated string. (Without this, string literals would pick
+    /// `append(bool)`.)
+    basic_static_string_builder& append(const CharT* str);
+
+    /// @brief Appends `count` copies of `c`.
+    basic_static_string_builder& append(size_type count, CharT c);
+
+    basic_static_string_builder& append(CharT c);
+
+    /// @brief Appends `"true"` or `"false"`.
+    basic_static_string_builder& append(bool value);
+
+    /// @brief Appends the decimal representation of an integer.
+    template <class T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value
+                                               && !std::is_same<T, CharT>::value, int>::type = 0>
+    basic_static_string_builder& append(T value);
+
+    /// @brief Appends the shortest representation of a floating-point number which reads back
+    /// to the same value.
+    template <class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    basic_static_string_builder& append(T value);
+
+    /// @brief Same as `append(str)`.
+    template <class T>
+    basic_static_string_builder& operator<<(const T& value);
+
+    /// @brief Passes the content to the callback (if there is anything) and clears the builder.
+    void flush();
+
+    /// @brief Empties the builder without calling the callback.
+    void clear() noexcept;
+
+// Conversions
+
+    operator sv_type() const noexcept;
+
+    basic_static_string<CharT, N> to_static_string() const noexcept;
+
+private:
+    /// @brief The most characters `append` writes for one number of type `T`.
+    template <class T>
+    static constexpr size_type number_capacity() noexcept;
+
+    /// @brief Makes room for a fragment of `count` characters which doesn't fit. Returns `false`
+    /// if the fragment can't go into the buffer (it was flushed or dropped by then).
+    bool overflow(const CharT* str, size_type count);
+
+    /// @brief `false` if the callback is an empty `std::function` or a null function pointer.
+    bool has_callback() const noexcept;
+
+    /// @brief Converts a number with `std::to_chars` and appends it.
+    template <class T>
+    basic_static_string_builder& append_number(T value);
+
+    CharT buffer[N == 0 ? 1 : N];
+    size_type length = 0;
+    bool dropped = false;
+    Flush callback {};
+};
+
+
+#define ASH_bssb_template template <class CharT, std::size_t N, class Flush>
+#define ASH_bssb_name ash::basic_static_string_builder<CharT, N, Flush>
+
+ASH_bssb_template
+ASH_bssb_name::basic_static_string_builder(Flush flush) noexcept(std::is_nothrow_move_constructible<Flush>::value)
+    : callback(std::move(flush)) {}
+
+ASH_bssb_template
+typename ASH_bssb_name::size_type ASH_bssb_name::size() const noexcept {
+    return length;
+}
+
+ASH_bssb_template
+bool ASH_bssb_name::empty() const noexcept {
+    return length == 0;
+}
+
+ASH_bssb_template
+bool ASH_bssb_name::truncated() const noexcept {
+    return dropped;
+}
+
+ASH_bssb_template
+const CharT* ASH_bssb_name::data() const noexcept {
+    return buffer;
+}
+
+ASH_bssb_template
+typename ASH_bssb_name::sv_type ASH_bssb_name::view() const noexcept {
+    return sv_type(buffer, length);
+}
+
+ASH_bssb_template
+ASH_bssb_name& ASH_bssb_name::append(sv_type str) {
+    if (str.size() > N - length && !overflow(str.data(), str.size()))
+        return *this;
+
+    std::memcpy(buffer + length, str.data(), str.size() * sizeof(CharT));
+    length += str.size();
+
+    return *this;
+}
+
+ASH_bssb_template
+ASH_bssb_name& ASH_bssb_name::append(const CharT* str) {
+    return append(sv_type(str));
+}
+
+ASH_bssb_template
+ASH_bssb_name& ASH_bssb_name::append(size_type count, CharT c) {
+    // Rarely more than a few characters of padding, so it goes through `append(c)` when it's large.
+    if (count > N - length) {
+        for (size_type i = 0; i < count; ++i)
+            append(c);
+
+        return *this;
+    }
+
+    std::fill_n(buffer + length, count, c);
+    length += count;
+
+    return *this;
+}
+
+ASH_bssb_template
+ASH_bssb_name& ASH_bssb_name::append(CharT c) {
+    if (length == N && !overflow(&c, 1))
+        return *this;
+
+    buffer[length++] = c;
+
+    return *this;
+}
+
+ASH_bssb_template
+ASH_bssb_name& ASH_bssb_name::append(bool value) {
+    static constexpr CharT text[] = { 'f', 'a', 'l', 's', 'e', 't', 'r', 'u', 'e' };
+
+    return value ? append(sv_type(text + 5, 4)) : append(sv_type(text, 5));
+}
+
+ASH_bssb_template
+template <class T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value
+                                           && !std::is_same<T, CharT>::value, int>::type>
+ASH_bssb_name& ASH_bssb_name::append(T value) {
+    return append_number(value);
+}
+
+ASH_bssb_template
+template <class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type>
+ASH_bssb_name& ASH_bssb_name::append(T value) {
+    return append_number(value);
+}
+
+ASH_bssb_template
+template <class T>
+ASH_bssb_name& ASH_bssb_name::operator<<(const T& value) {
+    if constexpr (std::is_convertible<const T&, sv_type>::value)
+        return append(sv_type(value));
+    else
+        return append(value);
+}
+
+ASH_bssb_template
+void ASH_bssb_name::flush() {
+    if (length == 0)
+        return;
+
+    // Emptied first, so the builder is usable again if the callback throws.
+    size_type count = length;
+    length = 0;
+
+    if (has_callback())
+        callback(sv_type(buffer, count));
+}
+
+ASH_bssb_template
+void ASH_bssb_name::clear() noexcept {
+    length = 0;
+    dropped = false;
+}
+
+ASH_bssb_template
+ASH_bssb_name::operator sv_type() const noexcept {
+    return view();
+}
+
+ASH_bssb_template
+ash::basic_static_string<CharT, N> ASH_bssb_name::to_static_string() const noexcept {
+    basic_static_string<CharT, N> result;
+    result.resize_and_overwrite(length, [this](CharT* out, size_type) {
+        std::memcpy(out, buffer, length * sizeof(CharT));
+        return length;
+    });
+
+    return result;
+}
+
+ASH_bssb_template
+template <class T>
+constexpr typename ASH_bssb_name::size_type ASH_bssb_name::number_capacity() noexcept {
+    if constexpr (std::is_integral<T>::value)
+        return std::numeric_limits<T>::digits10 + 2;
+    else
+        // Sign, digits, point and exponent (e.g. "-1.2345678901234567e-308").
+        return 1 + std::numeric_limits<T>::max_digits10 + 1 + 2 + 4;
+}
+
+ASH_bssb_template
+bool ASH_bssb_name::overflow(const CharT* str, size_type count) {
+    if (!has_callback()) {
+        // Keeps the part that fits.
+        size_type fits = N - length;
+        std::memcpy(buffer + length, str, fits * sizeof(CharT));
+        length = N;
+        dropped = true;
+
+        return false;
+    }
+
+    flush();
+
+    if (count > N) {
+        callback(sv_type(str, count));
+        return false;
+    }
+
+    return true;
+}
+
+ASH_bssb_template
+bool ASH_bssb_name::has_callback() const noexcept {
+    if constexpr (std::is_constructible<bool, const Flush&>::value)
+        return static_cast<bool>(callback);
+    else
+        return true;
+}
+
+ASH_bssb_template
+template <class T>
+ASH_bssb_name& ASH_bssb_name::append_number(T value) {
+    constexpr size_type max = number_capacity<T>();
+
+    if constexpr (std::is_same<CharT, char>::value) {
+        // Straight into the buffer when there is room for the longest representation.
+        if (max <= N - length) {
+            length = static_cast<size_type>(std::to_chars(buffer + length, buffer + N, value).ptr - buffer);
+            return *this;
+        }
+    }
+
+    char digits[max];
+    size_type count = static_cast<size_type>(std::to_chars(digits, digits + max, value).ptr - digits);
+
+    CharT chars[max];
+    for (size_type i = 0; i < count; ++i)
+        chars[i] = static_cast<CharT>(digits[i]);
+
+    return append(sv_type(chars, count));
+}
+
+#undef ASH_bssb_template
+#undef ASH_bssb_name
+
+#endif // ASH_STATIC_STRING_BUILDER
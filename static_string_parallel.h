@@ -0,0 +1,461 @@
+/*
+================================================================================
+  ash/static_string_parallel.h - Parallel bulk algorithms over vectors of
+  `ash::basic_static_string`.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    Every algorithm takes an `ash::parallel_policy` as its first argument and
+    runs on an `ash::thread_pool` (by default `ash::thread_pool::shared()`).
+
+    - `ash::sort`: Radix sorts equal slices of the input in parallel, then
+      merges the slices with parallel merge-path merges.
+    - `ash::unique`: Removes consecutive duplicates.
+    - `ash::find_all`, `ash::find_all_if`: Indices of the matching strings.
+    - `ash::transform`, `ash::to_lower`, `ash::to_upper`, `ash::hash`:
+      Element-wise operations.
+    - `ash::group_by`: Groups the indices of the strings by a key.
+
+    The results never depend on the number of threads or on scheduling: they
+    are always the same as running the same algorithm sequentially. With
+    `parallel_policy::deterministic`, the work is also executed in order on
+    the calling thread, so user-supplied functions are called in a
+    reproducible order (useful for tests).
+
+  Usage:
+    #include "ash/static_string_parallel.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_STATIC_STRING_PARALLEL
+
+================================================================================
+*/
+
+#ifndef ASH_STATIC_STRING_PARALLEL
+#define ASH_STATIC_STRING_PARALLEL
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "../ash/static_string.h"
+#include "../ash/static_string_algorithm.h"
+#include "../ash/thread_pool.h"
+#include "../ash/hash.h"
+#include "../ash/type_traits.h"
+
+namespace ash {
+    /// @struct parallel_policy
+    /// @brief Controls how the parallel algorithms run.
+    struct parallel_policy {
+        /// @brief The pool to run on. If `nullptr`, `ash::thread_pool::shared()` is used.
+        ash::thread_pool* pool = nullptr;
+
+        /// @brief If `true`, everything runs in order on the calling thread.
+        bool deterministic = false;
+
+        /// @brief The minimum number of elements processed by a single task.
+        std::size_t grain = 4096;
+    };
+
+    /// @struct key_group
+    /// @brief One group of `ash::group_by`.
+    /// @tparam Key The type of the key.
+    template <class Key>
+    struct key_group {
+        /// @brief The key shared by all the elements of the group.
+        Key key;
+
+        /// @brief The indices of the elements, in ascending order.
+        std::vector<std::size_t> indices;
+    };
+
+    /// @brief Sorts a vector of strings in ascending order.
+    /// @param policy Execution policy.
+    /// @param vec The strings to sort.
+    /// @note The result is exactly the same as `ash::sort(vec)`.
+    template <class CharT, std::size_t N, class Allocator>
+    void sort(const parallel_policy& policy, std::vector<basic_static_string<CharT, N>, Allocator>& vec);
+
+    /// @brief Removes all the consecutive duplicates, just like `vec.erase(std::unique(...), vec.end())`.
+    /// @param policy Execution policy.
+    /// @param vec The strings. Sort them first to remove all the duplicates.
+    template <class CharT, std::size_t N, class Allocator>
+    void unique(const parallel_policy& policy, std::vector<basic_static_string<CharT, N>, Allocator>& vec);
+
+    /// @brief Finds all the strings which are equal to `value`.
+    /// @param policy Execution policy.
+    /// @param vec The strings to search.
+    /// @param value The string to find. The capacity doesn't matter.
+    /// @return The indices of the matching strings in ascending order.
+    template <class CharT, std::size_t N, class Allocator, std::size_t M>
+    std::vector<std::size_t> find_all(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec, const basic_static_string<CharT, M>& value);
+
+    /// @brief Finds all the strings for which `pred` returns `true`.
+    /// @param policy Execution policy.
+    /// @param vec The strings to search.
+    /// @param pred Any callable with the signature `bool(const basic_static_string<CharT, N>&)`.
+    /// It is called concurrently.
+    /// @return The indices of the matching strings in ascending order.
+    template <class CharT, std::size_t N, class Allocator, class UnaryPredicate>
+    std::vector<std::size_t> find_all_if(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec, UnaryPredicate pred);
+
+    /// @brief Stores `op(vec[i])` into `out[i]` for every element.
+    /// @param policy Execution policy.
+    /// @param vec The input strings.
+    /// @param out The output. It is resized to `vec.size()`, so `T` must be default constructible.
+    /// @param op Any callable with the signature `T(const basic_static_string<CharT, N>&)`.
+    /// It is called concurrently.
+    template <class CharT, std::size_t N, class Allocator, class T, class OutAllocator, class UnaryOperation>
+    void transform(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec, std::vector<T, OutAllocator>& out, UnaryOperation op);
+
+    /// @brief Converts all the English uppercase letters of all the strings to lowercase.
+    /// @param policy Execution policy.
+    /// @param vec The strings.
+    template <std::size_t N, class Allocator>
+    void to_lower(const parallel_policy& policy, std::vector<static_string<N>, Allocator>& vec);
+
+    /// @brief Converts all the English lowercase letters of all the strings to uppercase.
+    /// @param policy Execution policy.
+    /// @param vec The strings.
+    template <std::size_t N, class Allocator>
+    void to_upper(const parallel_policy& policy, std::vector<static_string<N>, Allocator>& vec);
+
+    /// @brief Hashes all the strings with `std::hash<basic_static_string<CharT, N>>`.
+    /// @param policy Execution policy.
+    /// @param vec The strings.
+    /// @return The hashes, in the same order as `vec`.
+    template <class CharT, std::size_t N, class Allocator>
+    std::vector<std::size_t> hash(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec);
+
+    /// @brief Groups the indices of the strings by `key_fn(vec[i])`.
+    /// @param policy Execution policy.
+    /// @param vec The strings.
+    /// @param key_fn Any callable with the signature `Key(const basic_static_string<CharT, N>&)`.
+    /// `Key` must be default constructible, equality comparable and hashable with `std::hash`.
+    /// It is called concurrently.
+    /// @return The groups, ordered by the index of their first element.
+    template <class CharT, std::size_t N, class Allocator, class KeyFunction>
+    auto group_by(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec, KeyFunction key_fn)
+        -> std::vector<key_group<ash::remove_cvref_t<decltype(key_fn(vec[0]))>>>;
+}
+
+namespace ash {
+    namespace __parallel_details {
+        /// @brief Calls `f(chunk, first, last)` for `chunks` equal slices of [`0`, `count`).
+        template <class Function>
+        void for_each_chunk(const parallel_policy& policy, std::size_t count, std::size_t chunks, Function&& f) {
+            auto task = [&](std::size_t chunk) {
+                f(chunk, count * chunk / chunks, count * (chunk + 1) / chunks);
+            };
+
+            if (policy.deterministic || chunks == 1) {
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                    task(chunk);
+                return;
+            }
+
+            ash::thread_pool& pool = policy.pool ? *policy.pool : ash::thread_pool::shared();
+            pool.run(chunks, task);
+        }
+
+        /// @brief The number of threads the algorithm can use. Doesn't touch the shared pool in
+        /// deterministic mode.
+        inline std::size_t concurrency_of(const parallel_policy& policy) {
+            if (policy.deterministic)
+                return 1;
+
+            return policy.pool ? policy.pool->concurrency() : ash::thread_pool::shared().concurrency();
+        }
+
+        /// @brief The number of slices to split `count` elements into.
+        inline std::size_t chunks_for(const parallel_policy& policy, std::size_t count) {
+            std::size_t grain = policy.grain ? policy.grain : 1;
+            std::size_t by_grain = (count + grain - 1) / grain;
+
+            // A few slices per thread, so the work stealing can balance uneven slices.
+            std::size_t limit = policy.deterministic ? 1 : concurrency_of(policy) * 4;
+
+            return std::max<std::size_t>(1, std::min(by_grain, limit));
+        }
+
+        /// @brief Finds how many elements of `a` are among the first `k` elements of
+        /// `std::merge(a, b)` (merge path).
+        template <class Less>
+        std::size_t co_rank(std::size_t k, const __radix_sort_details::entry* a, std::size_t m, const __radix_sort_details::entry* b, std::size_t n, Less less) {
+            std::size_t lo = (k > n) ? k - n : 0;
+            std::size_t hi = (k < m) ? k : m;
+
+            while (lo < hi) {
+                std::size_t i = lo + (hi - lo) / 2;
+                std::size_t j = k - i;
+
+                if (j > 0 && !less(b[j - 1], a[i]))
+                    lo = i + 1;
+                else
+                    hi = i;
+            }
+
+            return lo;
+        }
+
+        /// @brief Sorts `entries` with parallel radix sorts of the slices followed by rounds
+        /// of parallel pairwise merges.
+        template <class RandomIt>
+        void sort_entries(const parallel_policy& policy, std::vector<__radix_sort_details::entry>& entries, RandomIt strings) {
+            using __radix_sort_details::entry;
+
+            std::size_t count = entries.size();
+            std::size_t runs = chunks_for(policy, count);
+
+            std::vector<entry> scratch(count);
+            entry* data = entries.data();
+            entry* tmp = scratch.data();
+
+            std::vector<std::size_t> bounds(runs + 1);
+            for (std::size_t r = 0; r <= runs; ++r)
+                bounds[r] = count * r / runs;
+
+            for_each_chunk(policy, runs, runs, [&](std::size_t r, std::size_t, std::size_t) {
+                std::size_t first = bounds[r], last = bounds[r + 1];
+                if (last - first > 1)
+                    __radix_sort_details::msd_radix_sort(data + first, data + last, tmp + first, 7, strings);
+            });
+
+            auto less = [strings](const entry& a, const entry& b) {
+                return __radix_sort_details::less(a, b, strings);
+            };
+
+            std::size_t concurrency = concurrency_of(policy);
+
+            while (bounds.size() > 2) {
+                std::size_t pairs = (bounds.size() - 1) / 2;
+                std::size_t pieces = std::max<std::size_t>(1, concurrency / pairs);
+
+                // Every pair of runs is merged by `pieces` tasks. The output of a task is found by
+                // co-ranking its first and last output positions.
+                for_each_chunk(policy, pairs * pieces, pairs * pieces, [&](std::size_t t, std::size_t, std::size_t) {
+                    std::size_t p = t / pieces, piece = t % pieces;
+
+                    std::size_t first = bounds[2 * p], middle = bounds[2 * p + 1], last = bounds[2 * p + 2];
+                    const entry* a = data + first;
+                    const entry* b = data + middle;
+                    std::size_t m = middle - first, n = last - middle;
+
+                    std::size_t k0 = (m + n) * piece / pieces;
+                    std::size_t k1 = (m + n) * (piece + 1) / pieces;
+                    std::size_t i0 = co_rank(k0, a, m, b, n, less), i1 = co_rank(k1, a, m, b, n, less);
+
+                    std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), tmp + first + k0, less);
+                });
+
+                // An odd run has nobody to merge with, it's just copied.
+                if ((bounds.size() - 1) % 2 == 1) {
+                    std::size_t first = bounds[bounds.size() - 2], last = bounds.back();
+                    std::memcpy(tmp + first, data + first, (last - first) * sizeof(entry));
+                }
+
+                std::vector<std::size_t> merged;
+                for (std::size_t r = 0; r < bounds.size(); r += 2)
+                    merged.push_back(bounds[r]);
+                if (merged.back() != count)
+                    merged.push_back(count);
+
+                bounds.swap(merged);
+                std::swap(data, tmp);
+            }
+
+            if (data != entries.data())
+                entries.swap(scratch);
+        }
+    } // namespace __parallel_details
+}
+
+template <class CharT, std::size_t N, class Allocator>
+void ash::sort(const parallel_policy& policy, std::vector<basic_static_string<CharT, N>, Allocator>& vec) {
+    using __radix_sort_details::entry;
+    using value_t = basic_static_string<CharT, N>;
+
+    std::size_t count = vec.size();
+    std::size_t chunks = __parallel_details::chunks_for(policy, count);
+
+    std::vector<entry> entries(count);
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i)
+            entries[i] = entry { __radix_sort_details::prefix_key(vec[i]), i };
+    });
+
+    __parallel_details::sort_entries(policy, entries, vec.begin());
+
+    std::vector<value_t, Allocator> sorted(count, vec.get_allocator());
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i)
+            sorted[i] = std::move(vec[entries[i].index]);
+    });
+
+    vec.swap(sorted);
+}
+
+template <class CharT, std::size_t N, class Allocator>
+void ash::unique(const parallel_policy& policy, std::vector<basic_static_string<CharT, N>, Allocator>& vec) {
+    using value_t = basic_static_string<CharT, N>;
+
+    std::size_t count = vec.size();
+    std::size_t chunks = __parallel_details::chunks_for(policy, count);
+
+    // The flags are computed before anything is moved, since the first element of a slice
+    // is compared with the last element of the previous slice.
+    std::vector<unsigned char> keep(count);
+    std::vector<std::size_t> offsets(chunks + 1, 0);
+
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+        std::size_t kept = 0;
+        for (std::size_t i = first; i < last; ++i) {
+            keep[i] = (i == 0 || vec[i] != vec[i - 1]);
+            kept += keep[i];
+        }
+
+        offsets[chunk + 1] = kept;
+    });
+
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+        offsets[chunk + 1] += offsets[chunk];
+
+    std::vector<value_t, Allocator> result(offsets[chunks], vec.get_allocator());
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+        std::size_t out = offsets[chunk];
+        for (std::size_t i = first; i < last; ++i)
+            if (keep[i])
+                result[out++] = std::move(vec[i]);
+    });
+
+    vec.swap(result);
+}
+
+template <class CharT, std::size_t N, class Allocator, std::size_t M>
+std::vector<std::size_t> ash::find_all(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec, const basic_static_string<CharT, M>& value) {
+    return ash::find_all_if(policy, vec, [&value](const basic_static_string<CharT, N>& str) {
+        return str == value;
+    });
+}
+
+template <class CharT, std::size_t N, class Allocator, class UnaryPredicate>
+std::vector<std::size_t> ash::find_all_if(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec, UnaryPredicate pred) {
+    std::size_t count = vec.size();
+    std::size_t chunks = __parallel_details::chunks_for(policy, count);
+
+    std::vector<std::vector<std::size_t>> found(chunks);
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i)
+            if (pred(vec[i]))
+                found[chunk].push_back(i);
+    });
+
+    std::vector<std::size_t> result;
+    for (const auto& part : found)
+        result.insert(result.end(), part.begin(), part.end());
+
+    return result;
+}
+
+template <class CharT, std::size_t N, class Allocator, class T, class OutAllocator, class UnaryOperation>
+void ash::transform(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec, std::vector<T, OutAllocator>& out, UnaryOperation op) {
+    std::size_t count = vec.size();
+    std::size_t chunks = __parallel_details::chunks_for(policy, count);
+
+    out.resize(count);
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i)
+            out[i] = op(vec[i]);
+    });
+}
+
+template <std::size_t N, class Allocator>
+void ash::to_lower(const parallel_policy& policy, std::vector<static_string<N>, Allocator>& vec) {
+    std::size_t count = vec.size();
+    std::size_t chunks = __parallel_details::chunks_for(policy, count);
+
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i)
+            for (char& c : vec[i])
+                c = ash::to_lower(c);
+    });
+}
+
+template <std::size_t N, class Allocator>
+void ash::to_upper(const parallel_policy& policy, std::vector<static_string<N>, Allocator>& vec) {
+    std::size_t count = vec.size();
+    std::size_t chunks = __parallel_details::chunks_for(policy, count);
+
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i)
+            for (char& c : vec[i])
+                c = ash::to_upper(c);
+    });
+}
+
+template <class CharT, std::size_t N, class Allocator>
+std::vector<std::size_t> ash::hash(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec) {
+    std::vector<std::size_t> result;
+    ash::transform(policy, vec, result, std::hash<basic_static_string<CharT, N>>());
+    return result;
+}
+
+template <class CharT, std::size_t N, class Allocator, class KeyFunction>
+auto ash::group_by(const parallel_policy& policy, const std::vector<basic_static_string<CharT, N>, Allocator>& vec, KeyFunction key_fn)
+    -> std::vector<key_group<ash::remove_cvref_t<decltype(key_fn(vec[0]))>>> {
+    using key_t = ash::remove_cvref_t<decltype(key_fn(vec[0]))>;
+    using group_t = key_group<key_t>;
+
+    std::size_t count = vec.size();
+    std::size_t chunks = __parallel_details::chunks_for(policy, count);
+
+    // Every key belongs to one partition (by its hash). First, every slice splits its indices
+    // by partition, then every partition is grouped independently.
+    std::size_t partitions = chunks;
+    std::vector<key_t> keys(count);
+    std::vector<std::vector<std::size_t>> buckets(chunks * partitions);
+
+    __parallel_details::for_each_chunk(policy, count, chunks, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+        std::hash<key_t> hasher;
+        for (std::size_t i = first; i < last; ++i) {
+            keys[i] = key_fn(vec[i]);
+            buckets[chunk * partitions + hasher(keys[i]) % partitions].push_back(i);
+        }
+    });
+
+    std::vector<std::vector<group_t>> grouped(partitions);
+    __parallel_details::for_each_chunk(policy, partitions, partitions, [&](std::size_t p, std::size_t, std::size_t) {
+        std::unordered_map<key_t, std::size_t> slots;
+
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            for (std::size_t i : buckets[chunk * partitions + p]) {
+                auto inserted = slots.emplace(keys[i], grouped[p].size());
+                if (inserted.second)
+                    grouped[p].push_back(group_t { keys[i], {} });
+
+                grouped[p][inserted.first->second].indices.push_back(i);
+            }
+        }
+    });
+
+    std::vector<group_t> result;
+    for (auto& part : grouped)
+        for (auto& group : part)
+            result.push_back(std::move(group));
+
+    std::sort(result.begin(), result.end(), [](const group_t& a, const group_t& b) {
+        return a.indices.front() < b.indices.front();
+    });
+
+    return result;
+}
+
+#endif // ASH_STATIC_STRING_PARALLEL
@@ -0,0 +1,778 @@
+/*
+================================================================================
+  ash::basic_static_string_table - Columnar (struct-of-arrays) storage for
+  many strings with the same capacity.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `std::vector<ash::static_string<N>>` interleaves the size of every string
+    with its buffer, and pads every element to the alignment of `size_type`.
+    `ash::basic_static_string_table<CharT, N>` stores:
+
+    - All the characters in one 64-byte aligned block. Every row is padded
+      with nulls to a multiple of 16 bytes, so kernels can compare whole rows
+      with full-width loads and no tail handling.
+    - All the sizes in a separate array of the smallest unsigned type that
+      can hold `N` (1 byte for `N < 256`).
+
+    Scans (`find_equal`, `find_prefix`, ...) first match the size column 16
+    rows at a time, and only touch the rows that can match.
+
+    `operator[]` returns a proxy which converts to `basic_static_string` and
+    `std::basic_string_view`.
+
+  Usage:
+    #include "ash/static_string_table.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_STATIC_STRING_TABLE
+
+================================================================================
+*/
+
+#ifndef ASH_STATIC_STRING_TABLE
+#define ASH_STATIC_STRING_TABLE
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <vector>
+#include "../ash/static_string.h"
+#include "../ash/simd.h"
+#include "../ash/throw_if.h"
+#include "../ash/type_traits.h"
+
+namespace ash {
+    /// @class basic_static_string_table
+    /// @brief A growable table of strings with capacity `N`, stored column by column.
+    /// @tparam CharT Character-like type of each element.
+    /// @tparam N Capacity of every row.
+    template <class CharT, std::size_t N>
+    class basic_static_string_table;
+
+    /// @brief `ash::basic_static_string_table` of `char`s.
+    /// @tparam N Capacity of every row.
+    template <std::size_t N>
+    using static_string_table = basic_static_string_table<char, N>;
+
+    namespace __static_string_table_details {
+        /// @brief The smallest unsigned type which can hold `N`.
+        template <std::size_t N>
+        using length_t = ash::conditional_t<(N <= 0xFF), std::uint8_t,
+                         ash::conditional_t<(N <= 0xFFFF), std::uint16_t,
+                         std::uint32_t>>;
+
+        /// @brief The number of rows that the size column is matched at once.
+        constexpr std::size_t block_rows = 16;
+
+        /// @brief Builds a 16-bit mask of the rows in [`lengths`, `lengths + 16`) whose size is
+        /// equal to `value` (or at least `value`, if `at_least` is `true`).
+        template <class L>
+        std::uint32_t match_lengths(const L* lengths, L value, bool at_least) noexcept;
+
+#ifdef ASH_SIMD_SSE2
+        /// @brief Turns 16 lanes of `0` or `-1` (in one to four registers) into a bit mask.
+        inline std::uint32_t to_mask(const __m128i* lanes, std::size_t registers) noexcept {
+            if (registers == 1)
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(lanes[0]));
+
+            if (registers == 2)
+                return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(lanes[0], lanes[1])));
+
+            __m128i low = _mm_packs_epi32(lanes[0], lanes[1]);
+            __m128i high = _mm_packs_epi32(lanes[2], lanes[3]);
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(low, high)));
+        }
+
+        inline __m128i match_lanes(__m128i lengths, std::uint8_t value, bool at_least) noexcept {
+            __m128i v = _mm_set1_epi8(static_cast<char>(value));
+            return at_least
+                ? _mm_cmpeq_epi8(_mm_max_epu8(lengths, v), lengths)
+                : _mm_cmpeq_epi8(lengths, v);
+        }
+
+        inline __m128i match_lanes(__m128i lengths, std::uint16_t value, bool at_least) noexcept {
+            __m128i v = _mm_set1_epi16(static_cast<short>(value));
+            return at_least
+                ? _mm_cmpeq_epi16(_mm_subs_epu16(v, lengths), _mm_setzero_si128())
+                : _mm_cmpeq_epi16(lengths, v);
+        }
+
+        inline __m128i match_lanes(__m128i lengths, std::uint32_t value, bool at_least) noexcept {
+            __m128i v = _mm_set1_epi32(static_cast<int>(value));
+            if (!at_least)
+                return _mm_cmpeq_epi32(lengths, v);
+
+            // There is no unsigned comparison in SSE2, so flip the sign bits first.
+            __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+            __m128i less = _mm_cmpgt_epi32(_mm_xor_si128(v, sign), _mm_xor_si128(lengths, sign));
+            return _mm_xor_si128(less, _mm_set1_epi32(-1));
+        }
+#endif
+    } // namespace __static_string_table_details
+}
+
+template <class L>
+std::uint32_t ash::__static_string_table_details::match_lengths(const L* lengths, L value, bool at_least) noexcept {
+#ifdef ASH_SIMD_SSE2
+    constexpr std::size_t per_register = 16 / sizeof(L);
+    constexpr std::size_t registers = block_rows / per_register;
+
+    __m128i lanes[registers];
+    for (std::size_t r = 0; r < registers; ++r) {
+        __m128i loaded = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lengths + r * per_register));
+        lanes[r] = match_lanes(loaded, value, at_least);
+    }
+
+    return to_mask(lanes, registers);
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < block_rows; ++i)
+        mask |= static_cast<std::uint32_t>(at_least ? lengths[i] >= value : lengths[i] == value) << i;
+
+    return mask;
+#endif
+}
+
+template <class CharT, std::size_t N>
+class ash::basic_static_string_table {
+public:
+
+// Nested types
+
+    using value_type = basic_static_string<CharT, N>;
+    using char_type = CharT;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    /// @brief Type of the elements of the size column.
+    using length_type = __static_string_table_details::length_t<N>;
+
+    /// @brief A helper type to avoid boiler-plate for `string_view`.
+    using sv_type = std::basic_string_view<CharT>;
+
+    /// @brief Number of characters between the beginnings of two consecutive rows.
+    /// Every row is padded with nulls up to this.
+    static constexpr size_type stride = ash::simd::round_up(N * sizeof(CharT)) / sizeof(CharT);
+
+    /// @brief Alignment of the character block in bytes.
+    static constexpr size_type alignment = 64;
+
+    class reference;
+    class const_reference;
+
+    template <bool Const>
+    class basic_iterator;
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+// Constructors
+
+    basic_static_string_table() noexcept = default;
+
+    /// @brief Constructs a table with `count` empty rows.
+    /// @param count Number of rows.
+    explicit basic_static_string_table(size_type count);
+
+    basic_static_string_table(const basic_static_string_table& other);
+    basic_static_string_table(basic_static_string_table&& other) noexcept;
+
+    basic_static_string_table& operator=(const basic_static_string_table& other);
+    basic_static_string_table& operator=(basic_static_string_table&& other) noexcept;
+
+// Element access
+
+    /// @brief Accesses the row at `row`. No bounds checking is performed.
+    reference operator[](size_type row) noexcept;
+
+    /// @brief Accesses the row at `row`. No bounds checking is performed.
+    const_reference operator[](size_type row) const noexcept;
+
+    /// @brief Accesses the row at `row`.
+    /// @exception `std::out_of_range` if `row` is equal or more than `size()`.
+    reference at(size_type row);
+
+    /// @brief Accesses the row at `row`.
+    /// @exception `std::out_of_range` if `row` is equal or more than `size()`.
+    const_reference at(size_type row) const;
+
+    /// @brief Pointer to the character block. Row `i` starts at `chars() + i * stride`.
+    const CharT* chars() const noexcept;
+
+    /// @brief Pointer to the size column.
+    const length_type* lengths() const noexcept;
+
+// Iterators
+
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator cbegin() const noexcept;
+
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cend() const noexcept;
+
+// Capacity
+
+    /// @brief Checks whether the table has no rows.
+    bool empty() const noexcept;
+
+    /// @brief Number of rows.
+    size_type size() const noexcept;
+
+    /// @brief Number of rows that the table has allocated space for.
+    size_type capacity() const noexcept;
+
+    /// @brief Makes sure at least `count` rows fit without reallocation.
+    void reserve(size_type count);
+
+// Modifiers
+
+    /// @brief Removes all the rows. The capacity doesn't change.
+    void clear() noexcept;
+
+    /// @brief Changes the number of rows to `count`. New rows are empty.
+    void resize(size_type count);
+
+    /// @brief Appends a row.
+    /// @param str The string to append.
+    /// @exception `std::out_of_range` if `str.size()` is more than `N`.
+    template <std::size_t other_N>
+    void push_back(const basic_static_string<CharT, other_N>& str);
+
+    /// @brief Appends a row.
+    /// @param str The string to append.
+    /// @exception `std::out_of_range` if `str.size()` is more than `N`.
+    void push_back(sv_type str);
+
+    /// @brief Replaces the contents of row `row`. No bounds checking is performed on `row`.
+    /// @exception `std::out_of_range` if `str.size()` is more than `N`.
+    void assign(size_type row, sv_type str);
+
+// Batch kernels
+
+    /// @brief Finds all the rows which are equal to `key`.
+    /// @return The indices of the rows in ascending order.
+    std::vector<size_type> find_equal(sv_type key) const;
+
+    /// @brief Counts the rows which are equal to `key`.
+    size_type count_equal(sv_type key) const;
+
+    /// @brief Finds all the rows which start with `prefix`.
+    /// @return The indices of the rows in ascending order.
+    std::vector<size_type> find_prefix(sv_type prefix) const;
+
+    /// @brief Counts the rows which start with `prefix`.
+    size_type count_prefix(sv_type prefix) const;
+
+    /// @brief Calls `f(row)` for every row which is equal to `key`, in ascending order.
+    template <class Function>
+    void for_each_equal(sv_type key, Function&& f) const;
+
+    /// @brief Calls `f(row)` for every row which starts with `prefix`, in ascending order.
+    template <class Function>
+    void for_each_prefix(sv_type prefix, Function&& f) const;
+
+private:
+    struct aligned_delete {
+        void operator()(CharT* p) const noexcept {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+    };
+
+    using block_t = std::unique_ptr<CharT[], aligned_delete>;
+
+    /// @brief Allocates a zero-filled block for `rows` rows.
+    static block_t allocate(size_type rows);
+
+    CharT* row_ptr(size_type row) noexcept;
+    const CharT* row_ptr(size_type row) const noexcept;
+
+    void grow(size_type min_rows);
+
+    /// @brief Copies `key` into a zero-padded row-shaped buffer, so it can be compared with
+    /// full-width loads.
+    static void pad_key(sv_type key, CharT (&out)[stride == 0 ? 1 : stride]) noexcept;
+
+    block_t block;
+
+    /// @brief Always padded to a multiple of 16 rows with zeros, so the size column can be
+    /// scanned 16 rows at a time.
+    std::vector<length_type> sizes;
+
+    size_type rows = 0;
+    size_type row_capacity = 0;
+};
+
+/// @class reference
+/// @brief Proxy for a mutable row.
+template <class CharT, std::size_t N>
+class ash::basic_static_string_table<CharT, N>::reference {
+    friend class basic_static_string_table;
+    friend class const_reference;
+
+    reference(basic_static_string_table* table, size_type row) noexcept : table(table), row(row) {}
+
+public:
+    /// @brief Number of characters in the row.
+    size_type size() const noexcept { return table->sizes[row]; }
+
+    /// @brief Pointer to the first character of the row. The row is padded with nulls.
+    const CharT* data() const noexcept { return table->row_ptr(row); }
+
+    /// @brief Copies the row into a `basic_static_string`.
+    operator value_type() const { return value_type(data(), size()); }
+
+    /// @brief A view over the row. It is invalidated when the table reallocates.
+    operator sv_type() const noexcept { return sv_type(data(), size()); }
+
+    /// @brief Replaces the contents of the row.
+    /// @exception `std::out_of_range` if `str.size()` is more than `N`.
+    reference& operator=(sv_type str) {
+        table->assign(row, str);
+        return *this;
+    }
+
+    /// @brief Replaces the contents of the row.
+    /// @exception `std::out_of_range` if `str.size()` is more than `N`.
+    template <std::size_t other_N>
+    reference& operator=(const basic_static_string<CharT, other_N>& str) {
+        table->assign(row, sv_type(str.data(), str.size()));
+        return *this;
+    }
+
+    /// @brief Copies the contents of another row (even from another table).
+    reference& operator=(const reference& other) {
+        table->assign(row, sv_type(other));
+        return *this;
+    }
+
+    friend bool operator==(const reference& lhs, sv_type rhs) noexcept { return sv_type(lhs) == rhs; }
+    friend bool operator!=(const reference& lhs, sv_type rhs) noexcept { return sv_type(lhs) != rhs; }
+
+private:
+    basic_static_string_table* table;
+    size_type row;
+};
+
+/// @class const_reference
+/// @brief Proxy for a read-only row.
+template <class CharT, std::size_t N>
+class ash::basic_static_string_table<CharT, N>::const_reference {
+    friend class basic_static_string_table;
+
+    const_reference(const basic_static_string_table* table, size_type row) noexcept : table(table), row(row) {}
+
+public:
+    const_reference(const reference& other) noexcept : table(other.table), row(other.row) {}
+
+    /// @brief Number of characters in the row.
+    size_type size() const noexcept { return table->sizes[row]; }
+
+    /// @brief Pointer to the first character of the row. The row is padded with nulls.
+    const CharT* data() const noexcept { return table->row_ptr(row); }
+
+    /// @brief Copies the row into a `basic_static_string`.
+    operator value_type() const { return value_type(data(), size()); }
+
+    /// @brief A view over the row. It is invalidated when the table reallocates.
+    operator sv_type() const noexcept { return sv_type(data(), size()); }
+
+    friend bool operator==(const const_reference& lhs, sv_type rhs) noexcept { return sv_type(lhs) == rhs; }
+    friend bool operator!=(const const_reference& lhs, sv_type rhs) noexcept { return sv_type(lhs) != rhs; }
+
+private:
+    const basic_static_string_table* table;
+    size_type row;
+};
+
+/// @class basic_iterator
+/// @brief Random access iterator over the rows. Dereferencing returns a proxy by value.
+template <class CharT, std::size_t N>
+template <bool Const>
+class ash::basic_static_string_table<CharT, N>::basic_iterator {
+    friend class basic_static_string_table;
+
+    using table_pointer = ash::conditional_t<Const, const basic_static_string_table*, basic_static_string_table*>;
+
+    basic_iterator(table_pointer table, size_type row) noexcept : table(table), row(row) {}
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename basic_static_string_table::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = ash::conditional_t<Const, typename basic_static_string_table::const_reference, typename basic_static_string_table::reference>;
+    using pointer = void;
+
+    basic_iterator() noexcept = default;
+
+    /// @brief Converts a mutable iterator to a const one.
+    template <bool OtherConst, typename = ash::enable_if_t<Const && !OtherConst>>
+    basic_iterator(const basic_iterator<OtherConst>& other) noexcept : table(other.table), row(other.row) {}
+
+    reference operator*() const noexcept { return (*table)[row]; }
+    reference operator[](difference_type n) const noexcept { return (*table)[row + n]; }
+
+    basic_iterator& operator++() noexcept { ++row; return *this; }
+    basic_iterator operator++(int) noexcept { basic_iterator copy = *this; ++row; return copy; }
+    basic_iterator& operator--() noexcept { --row; return *this; }
+    basic_iterator operator--(int) noexcept { basic_iterator copy = *this; --row; return copy; }
+
+    basic_iterator& operator+=(difference_type n) noexcept { row += n; return *this; }
+    basic_iterator& operator-=(difference_type n) noexcept { row -= n; return *this; }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept { return it += n; }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept { return it += n; }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return static_cast<difference_type>(a.row) - static_cast<difference_type>(b.row);
+    }
+
+    friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.row == b.row; }
+    friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept { return a.row != b.row; }
+    friend bool operator<(const basic_iterator& a, const basic_iterator& b) noexcept { return a.row < b.row; }
+    friend bool operator>(const basic_iterator& a, const basic_iterator& b) noexcept { return a.row > b.row; }
+    friend bool operator<=(const basic_iterator& a, const basic_iterator& b) noexcept { return a.row <= b.row; }
+    friend bool operator>=(const basic_iterator& a, const basic_iterator& b) noexcept { return a.row >= b.row; }
+
+private:
+    template <bool>
+    friend class basic_iterator;
+
+    table_pointer table = nullptr;
+    size_type row = 0;
+};
+
+
+#define ASH_sst_template \
+    template <class CharT, std::size_t N>
+
+#define ASH_sst_name \
+    ash::basic_static_string_table<CharT, N>
+
+ASH_sst_template
+ASH_sst_name::basic_static_string_table(size_type count) {
+    resize(count);
+}
+
+ASH_sst_template
+ASH_sst_name::basic_static_string_table(const basic_static_string_table& other) {
+    reserve(other.rows);
+
+    if (other.rows != 0)
+        std::memcpy(block.get(), other.block.get(), other.rows * stride * sizeof(CharT));
+
+    sizes = other.sizes;
+    rows = other.rows;
+}
+
+ASH_sst_template
+ASH_sst_name::basic_static_string_table(basic_static_string_table&& other) noexcept
+    : block(std::move(other.block)), sizes(std::move(other.sizes)), rows(other.rows), row_capacity(other.row_capacity) {
+    other.rows = 0;
+    other.row_capacity = 0;
+}
+
+ASH_sst_template
+ASH_sst_name& ASH_sst_name::operator=(const basic_static_string_table& other) {
+    if (this != &other) {
+        basic_static_string_table copy(other);
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+ASH_sst_template
+ASH_sst_name& ASH_sst_name::operator=(basic_static_string_table&& other) noexcept {
+    block = std::move(other.block);
+    sizes = std::move(other.sizes);
+    rows = other.rows;
+    row_capacity = other.row_capacity;
+
+    other.rows = 0;
+    other.row_capacity = 0;
+    return *this;
+}
+
+ASH_sst_template
+typename ASH_sst_name::reference ASH_sst_name::operator[](size_type row) noexcept {
+    return reference(this, row);
+}
+
+ASH_sst_template
+typename ASH_sst_name::const_reference ASH_sst_name::operator[](size_type row) const noexcept {
+    return const_reference(this, row);
+}
+
+ASH_sst_template
+typename ASH_sst_name::reference ASH_sst_name::at(size_type row) {
+    ash::throw_if_outside_of_size(rows, row);
+    return reference(this, row);
+}
+
+ASH_sst_template
+typename ASH_sst_name::const_reference ASH_sst_name::at(size_type row) const {
+    ash::throw_if_outside_of_size(rows, row);
+    return const_reference(this, row);
+}
+
+ASH_sst_template
+const CharT* ASH_sst_name::chars() const noexcept {
+    return block.get();
+}
+
+ASH_sst_template
+const typename ASH_sst_name::length_type* ASH_sst_name::lengths() const noexcept {
+    return sizes.data();
+}
+
+ASH_sst_template
+typename ASH_sst_name::iterator ASH_sst_name::begin() noexcept {
+    return iterator(this, 0);
+}
+
+ASH_sst_template
+typename ASH_sst_name::const_iterator ASH_sst_name::begin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+ASH_sst_template
+typename ASH_sst_name::const_iterator ASH_sst_name::cbegin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+ASH_sst_template
+typename ASH_sst_name::iterator ASH_sst_name::end() noexcept {
+    return iterator(this, rows);
+}
+
+ASH_sst_template
+typename ASH_sst_name::const_iterator ASH_sst_name::end() const noexcept {
+    return const_iterator(this, rows);
+}
+
+ASH_sst_template
+typename ASH_sst_name::const_iterator ASH_sst_name::cend() const noexcept {
+    return const_iterator(this, rows);
+}
+
+ASH_sst_template
+bool ASH_sst_name::empty() const noexcept {
+    return rows == 0;
+}
+
+ASH_sst_template
+typename ASH_sst_name::size_type ASH_sst_name::size() const noexcept {
+    return rows;
+}
+
+ASH_sst_template
+typename ASH_sst_name::size_type ASH_sst_name::capacity() const noexcept {
+    return row_capacity;
+}
+
+ASH_sst_template
+void ASH_sst_name::reserve(size_type count) {
+    if (count <= row_capacity)
+        return;
+
+    // Keep the capacity a multiple of the size column block, so `sizes` never needs extra padding.
+    using __static_string_table_details::block_rows;
+    count = (count + block_rows - 1) / block_rows * block_rows;
+
+    block_t bigger = allocate(count);
+    if (rows != 0)
+        std::memcpy(bigger.get(), block.get(), rows * stride * sizeof(CharT));
+
+    block = std::move(bigger);
+    sizes.resize(count, 0);
+    row_capacity = count;
+}
+
+ASH_sst_template
+void ASH_sst_name::clear() noexcept {
+    if (rows != 0)
+        std::memset(static_cast<void*>(block.get()), 0, rows * stride * sizeof(CharT));
+
+    std::fill(sizes.begin(), sizes.end(), length_type(0));
+    rows = 0;
+}
+
+ASH_sst_template
+void ASH_sst_name::resize(size_type count) {
+    if (count < rows) {
+        std::memset(static_cast<void*>(row_ptr(count)), 0, (rows - count) * stride * sizeof(CharT));
+        std::fill(sizes.begin() + count, sizes.begin() + rows, length_type(0));
+    }
+    else if (count > row_capacity) {
+        grow(count);
+    }
+
+    rows = count;
+}
+
+ASH_sst_template
+template <std::size_t other_N>
+void ASH_sst_name::push_back(const basic_static_string<CharT, other_N>& str) {
+    push_back(sv_type(str.data(), str.size()));
+}
+
+ASH_sst_template
+void ASH_sst_name::push_back(sv_type str) {
+    ash::throw_if_outside_of_capacity(N, str.size());
+
+    if (rows == row_capacity)
+        grow(rows + 1);
+
+    std::memcpy(row_ptr(rows), str.data(), str.size() * sizeof(CharT));
+    sizes[rows] = static_cast<length_type>(str.size());
+    ++rows;
+}
+
+ASH_sst_template
+void ASH_sst_name::assign(size_type row, sv_type str) {
+    ash::throw_if_outside_of_capacity(N, str.size());
+
+    CharT* dest = row_ptr(row);
+    size_type old_size = sizes[row];
+
+    std::memmove(dest, str.data(), str.size() * sizeof(CharT));
+    if (str.size() < old_size)
+        std::memset(static_cast<void*>(dest + str.size()), 0, (old_size - str.size()) * sizeof(CharT));
+
+    sizes[row] = static_cast<length_type>(str.size());
+}
+
+ASH_sst_template
+std::vector<typename ASH_sst_name::size_type> ASH_sst_name::find_equal(sv_type key) const {
+    std::vector<size_type> result;
+    for_each_equal(key, [&result](size_type row) { result.push_back(row); });
+    return result;
+}
+
+ASH_sst_template
+typename ASH_sst_name::size_type ASH_sst_name::count_equal(sv_type key) const {
+    size_type count = 0;
+    for_each_equal(key, [&count](size_type) { ++count; });
+    return count;
+}
+
+ASH_sst_template
+std::vector<typename ASH_sst_name::size_type> ASH_sst_name::find_prefix(sv_type prefix) const {
+    std::vector<size_type> result;
+    for_each_prefix(prefix, [&result](size_type row) { result.push_back(row); });
+    return result;
+}
+
+ASH_sst_template
+typename ASH_sst_name::size_type ASH_sst_name::count_prefix(sv_type prefix) const {
+    size_type count = 0;
+    for_each_prefix(prefix, [&count](size_type) { ++count; });
+    return count;
+}
+
+ASH_sst_template
+template <class Function>
+void ASH_sst_name::for_each_equal(sv_type key, Function&& f) const {
+    using namespace __static_string_table_details;
+
+    if (key.size() > N)
+        return;
+
+    CharT padded[stride == 0 ? 1 : stride];
+    pad_key(key, padded);
+
+    // Rows are null padded just like `padded`, so if the sizes match, comparing the
+    // 16-byte blocks which hold the characters is enough.
+    const size_type bytes = ash::simd::round_up(key.size() * sizeof(CharT));
+    const length_type len = static_cast<length_type>(key.size());
+
+    for (size_type base = 0; base < rows; base += block_rows) {
+        std::uint32_t mask = match_lengths(sizes.data() + base, len, false);
+        if (rows - base < block_rows)
+            mask &= (1u << (rows - base)) - 1;
+
+        while (mask != 0) {
+            size_type row = base + ash::simd::ctz(mask);
+            mask &= mask - 1;
+
+            if (ash::simd::equal_padded(row_ptr(row), padded, bytes))
+                f(row);
+        }
+    }
+}
+
+ASH_sst_template
+template <class Function>
+void ASH_sst_name::for_each_prefix(sv_type prefix, Function&& f) const {
+    using namespace __static_string_table_details;
+
+    if (prefix.size() > N)
+        return;
+
+    CharT padded[stride == 0 ? 1 : stride];
+    pad_key(prefix, padded);
+
+    const size_type bytes = prefix.size() * sizeof(CharT);
+    const length_type len = static_cast<length_type>(prefix.size());
+
+    for (size_type base = 0; base < rows; base += block_rows) {
+        std::uint32_t mask = match_lengths(sizes.data() + base, len, true);
+        if (rows - base < block_rows)
+            mask &= (1u << (rows - base)) - 1;
+
+        while (mask != 0) {
+            size_type row = base + ash::simd::ctz(mask);
+            mask &= mask - 1;
+
+            if (ash::simd::prefix_equal_padded(row_ptr(row), padded, bytes))
+                f(row);
+        }
+    }
+}
+
+ASH_sst_template
+typename ASH_sst_name::block_t ASH_sst_name::allocate(size_type count) {
+    std::size_t bytes = count * stride * sizeof(CharT);
+    void* p = ::operator new(bytes == 0 ? alignment : bytes, std::align_val_t(alignment));
+    std::memset(p, 0, bytes);
+    return block_t(static_cast<CharT*>(p));
+}
+
+ASH_sst_template
+CharT* ASH_sst_name::row_ptr(size_type row) noexcept {
+    return block.get() + row * stride;
+}
+
+ASH_sst_template
+const CharT* ASH_sst_name::row_ptr(size_type row) const noexcept {
+    return block.get() + row * stride;
+}
+
+ASH_sst_template
+void ASH_sst_name::grow(size_type min_rows) {
+    size_type doubled = row_capacity * 2;
+    reserve(doubled > min_rows ? doubled : min_rows);
+}
+
+ASH_sst_template
+void ASH_sst_name::pad_key(sv_type key, CharT (&out)[stride == 0 ? 1 : stride]) noexcept {
+    std::memset(static_cast<void*>(out), 0, sizeof(out));
+    std::memcpy(out, key.data(), key.size() * sizeof(CharT));
+}
+
+#undef ASH_sst_template
+#undef ASH_sst_name
+
+#endif // ASH_STATIC_STRING_TABLE
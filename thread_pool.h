@@ -0,0 +1,279 @@
+/*
+================================================================================
+  ash/thread_pool.h - A small work-stealing thread pool for fork-join loops.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    `ash::thread_pool` owns a fixed number of worker threads. Every worker has
+    its own task queue; a worker takes tasks from the back of its own queue and
+    steals from the front of the other queues when its own queue is empty.
+
+    The only way to submit work is `run(count, f)` which calls `f(i)` for every
+    `i` in [`0`, `count`) and blocks until all of them are done. The calling
+    thread executes tasks too, so calling `run` from inside a task is fine.
+
+  Usage:
+    #include "ash/thread_pool.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_THREAD_POOL
+
+================================================================================
+*/
+
+#ifndef ASH_THREAD_POOL
+#define ASH_THREAD_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../ash/type_traits.h"
+
+namespace ash {
+    /// @class thread_pool
+    /// @brief A fixed-size pool of worker threads with one task queue per worker and work stealing.
+    class thread_pool;
+}
+
+class ash::thread_pool {
+// Nested types
+
+    /// @brief A call to `run` that is still in progress. It lives on the stack of the
+    /// thread which called `run`.
+    struct job {
+        virtual void execute(std::size_t index) = 0;
+
+        std::atomic<std::size_t> remaining { 0 };
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+    protected:
+        ~job() = default;
+    };
+
+    template <class Function>
+    struct function_job final : job {
+        explicit function_job(Function& f) : f(f) {}
+
+        void execute(std::size_t index) override {
+            f(index);
+        }
+
+        Function& f;
+    };
+
+    struct task {
+        job* owner;
+        std::size_t index;
+    };
+
+    struct queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+public:
+
+// Constructors
+
+    /// @brief Starts `threads` worker threads.
+    /// @param threads Number of workers. If `0`, uses `std::thread::hardware_concurrency() - 1`
+    /// (the thread which calls `run` works as well).
+    explicit thread_pool(std::size_t threads = 0);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// @brief Stops and joins all the workers. Must not be called while a `run` is in progress.
+    ~thread_pool();
+
+// Capacity
+
+    /// @brief The number of threads that execute tasks during a `run`, which is the number of
+    /// workers plus the calling thread.
+    std::size_t concurrency() const noexcept;
+
+// Operations
+
+    /// @brief Calls `f(i)` for every `i` in [`0`, `count`) on the workers and the calling thread,
+    /// then waits for all of them.
+    /// @param count The number of tasks.
+    /// @param f Any callable with the signature `void(std::size_t)`. It is called concurrently.
+    /// @exception Rethrows the first exception thrown by `f`. All the other tasks are still executed.
+    template <class Function>
+    void run(std::size_t count, Function&& f);
+
+    /// @brief A process-wide pool which is created on first use.
+    static thread_pool& shared();
+
+private:
+    bool try_pop(std::size_t self, task& out);
+    bool try_steal(std::size_t self, task& out);
+    static void execute(const task& t) noexcept;
+    void worker_loop(std::size_t self);
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<std::size_t> pending { 0 };
+    bool stopping = false;
+};
+
+inline ash::thread_pool::thread_pool(std::size_t threads) {
+    if (threads == 0) {
+        std::size_t hardware = std::thread::hardware_concurrency();
+        threads = (hardware > 1) ? hardware - 1 : 1;
+    }
+
+    for (std::size_t i = 0; i < threads; ++i)
+        queues.emplace_back(new queue());
+
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        workers.emplace_back(&thread_pool::worker_loop, this, i);
+}
+
+inline ash::thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+inline std::size_t ash::thread_pool::concurrency() const noexcept {
+    return workers.size() + 1;
+}
+
+template <class Function>
+void ash::thread_pool::run(std::size_t count, Function&& f) {
+    if (count == 0)
+        return;
+
+    function_job<ash::remove_reference_t<Function>> current(f);
+    current.remaining.store(count, std::memory_order_relaxed);
+
+    // Count the tasks before they are visible, so `pending` never goes below zero.
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        pending.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // Give every worker a contiguous range of tasks, so neighbour tasks (which usually touch
+    // neighbour memory) run on the same thread unless they are stolen.
+    std::size_t workers_count = queues.size();
+    for (std::size_t w = 0; w < workers_count; ++w) {
+        std::size_t first = count * w / workers_count;
+        std::size_t last = count * (w + 1) / workers_count;
+
+        if (first == last)
+            continue;
+
+        std::lock_guard<std::mutex> lock(queues[w]->mutex);
+        for (std::size_t i = first; i < last; ++i)
+            queues[w]->tasks.push_back(task { &current, i });
+    }
+
+    wake.notify_all();
+
+    // Help until every task of this job is finished. We may execute tasks of other jobs
+    // (e.g. a nested `run`) as well, that's fine.
+    task t;
+    while (current.remaining.load(std::memory_order_acquire) != 0) {
+        if (try_steal(workers_count, t))
+            execute(t);
+        else
+            std::this_thread::yield();
+    }
+
+    if (current.error)
+        std::rethrow_exception(current.error);
+}
+
+inline ash::thread_pool& ash::thread_pool::shared() {
+    static thread_pool pool;
+    return pool;
+}
+
+inline bool ash::thread_pool::try_pop(std::size_t self, task& out) {
+    queue& own = *queues[self];
+
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.tasks.empty())
+        return false;
+
+    out = own.tasks.back();
+    own.tasks.pop_back();
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+inline bool ash::thread_pool::try_steal(std::size_t self, task& out) {
+    std::size_t count = queues.size();
+
+    for (std::size_t k = 1; k <= count; ++k) {
+        queue& victim = *queues[(self + k) % count];
+
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty())
+            continue;
+
+        out = victim.tasks.front();
+        victim.tasks.pop_front();
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+inline void ash::thread_pool::execute(const task& t) noexcept {
+    try {
+        t.owner->execute(t.index);
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(t.owner->error_mutex);
+        if (!t.owner->error)
+            t.owner->error = std::current_exception();
+    }
+
+    t.owner->remaining.fetch_sub(1, std::memory_order_release);
+}
+
+inline void ash::thread_pool::worker_loop(std::size_t self) {
+    task t;
+
+    while (true) {
+        if (try_pop(self, t) || try_steal(self, t)) {
+            execute(t);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] {
+            return stopping || pending.load(std::memory_order_relaxed) != 0;
+        });
+
+        if (stopping)
+            return;
+    }
+}
+
+#endif // ASH_THREAD_POOL
@@ -0,0 +1,379 @@
+/*
+================================================================================
+  ash/timestamp.h - ISO 8601 timestamps from and to nanoseconds since the epoch.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    - `ash::format_timestamp<P>(ns)` returns `YYYY-MM-DDTHH:MM:SS[.fraction]Z`
+      in a `static_string` of exactly the right capacity, e.g.
+      `static_string<30>` for nanoseconds and `static_string<20>` for seconds.
+    - `ash::parse_timestamp(str)` returns the nanoseconds since the epoch of
+      such a string. It also accepts a space or 't' instead of 'T', 0 to 9
+      fraction digits, and an offset (`+HH:MM`, `-HH:MM`) instead of 'Z'.
+
+    The formatter caches the date of the last day and the text of the last
+    second, so a timestamp in the same second as the previous one only
+    costs its fraction digits, and one in the same day only the time of day.
+    The digits are written two at a time from a table. The date is computed
+    with the `civil_from_days` algorithm of Howard Hinnant.
+
+    `format_timestamp` uses a `thread_local` formatter. A
+    `timestamp_formatter` object can be used instead, e.g. one per log sink.
+
+    The parser reads "YYYY-MM-", "HH:MM:SS" and 8 fraction digits at a time
+    as 64-bit words (SWAR): the digits are checked and combined with a few
+    masks and multiplies, instead of one at a time.
+
+  Usage:
+    #include "ash/timestamp.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_TIMESTAMP
+
+================================================================================
+*/
+
+#ifndef ASH_TIMESTAMP
+#define ASH_TIMESTAMP
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include "../ash/simd.h"
+#include "../ash/static_string.h"
+
+namespace ash {
+    /// @brief The number of fraction digits of a timestamp.
+    enum class timestamp_precision {
+        seconds = 0,
+        milliseconds = 3,
+        microseconds = 6,
+        nanoseconds = 9
+    };
+
+    /// @brief The size of a timestamp of precision `P`.
+    constexpr std::size_t timestamp_size(timestamp_precision P) noexcept {
+        // "YYYY-MM-DDTHH:MM:SS" + ".fraction" + "Z".
+        return 19 + (P == timestamp_precision::seconds ? 0 : 1 + static_cast<std::size_t>(P)) + 1;
+    }
+
+    /// @class timestamp_formatter
+    /// @brief Formats timestamps, reusing the date and the time of the previous one.
+    class timestamp_formatter;
+
+    /// @brief Formats `ns` (nanoseconds since the epoch, UTC) with a `thread_local` formatter.
+    template <timestamp_precision P = timestamp_precision::nanoseconds>
+    auto format_timestamp(std::int64_t ns) noexcept -> static_string<timestamp_size(P)>;
+
+    template <timestamp_precision P = timestamp_precision::nanoseconds, class Duration>
+    auto format_timestamp(std::chrono::time_point<std::chrono::system_clock, Duration> time) noexcept -> static_string<timestamp_size(P)>;
+
+    /// @brief Parses an ISO 8601 timestamp.
+    /// @return The nanoseconds since the epoch.
+    /// @exception `std::invalid_argument` if `str` is not a timestamp.
+    /// @exception `std::out_of_range` if it doesn't fit in 64 bits of nanoseconds (1677...2262).
+    std::int64_t parse_timestamp(std::string_view str);
+
+    namespace __timestamp_details {
+        /// @brief "00", "01", ..., "99".
+        constexpr char digit_pairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        inline void write2(char* out, unsigned value) noexcept {
+            std::memcpy(out, digit_pairs + 2 * value, 2);
+        }
+
+        /// @brief Writes the `count` last decimal digits of `value`.
+        inline void write_digits(char* out, std::uint32_t value, std::size_t count) noexcept {
+            for (; count >= 2; count -= 2) {
+                write2(out + count - 2, value % 100);
+                value /= 100;
+            }
+
+            if (count)
+                out[0] = static_cast<char>('0' + value % 10);
+        }
+
+        struct civil_date {
+            std::int64_t year;
+            unsigned month;
+            unsigned day;
+        };
+
+        /// @brief The date of the day `days` after 1970-01-01 (Hinnant).
+        constexpr civil_date civil_from_days(std::int64_t days) noexcept {
+            days += 719468;
+            std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+            auto doe = static_cast<unsigned>(days - era * 146097);
+            unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            unsigned mp = (5 * doy + 2) / 153;
+            unsigned day = doy - (153 * mp + 2) / 5 + 1;
+            unsigned month = mp < 10 ? mp + 3 : mp - 9;
+
+            return { static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2), month, day };
+        }
+
+        /// @brief The number of days from 1970-01-01 to the date (Hinnant).
+        constexpr std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day) noexcept {
+            year -= month <= 2;
+            std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+            auto yoe = static_cast<unsigned>(year - era * 400);
+            unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+            unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+            return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+        }
+
+        constexpr unsigned days_in_month(std::int64_t year, unsigned month) noexcept {
+            if (month == 2)
+                return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+
+            return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+        }
+
+        /// @brief `true` if the bytes of `word` selected by `mask` are all digits.
+        constexpr bool digits_at(std::uint64_t word, std::uint64_t mask) noexcept {
+            // A byte is a digit if its high nibble is 3, and adding 6 to it doesn't carry into it.
+            std::uint64_t high = word & 0xF0F0F0F0F0F0F0F0;
+            std::uint64_t carry = ((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4;
+
+            return ((high | carry) & mask) == (0x3333333333333333 & mask);
+        }
+
+        /// @brief Byte `i` of the result is `10 * digit[i] + digit[i + 1]`, where `digit` are the bytes
+        /// of `word` minus '0'. The bytes outside of `mask` are cleared first, so they don't carry.
+        constexpr std::uint64_t digit_pairs_of(std::uint64_t word, std::uint64_t mask) noexcept {
+            std::uint64_t digits = (word & mask) - (0x3030303030303030 & mask);
+            return digits * 10 + (digits >> 8);
+        }
+
+        /// @brief The value of 8 digits, read as a little-endian word.
+        constexpr std::uint32_t eight_digits(std::uint64_t word) noexcept {
+            word -= 0x3030303030303030;
+            word = word * 10 + (word >> 8);
+            word = (((word & 0x000000FF000000FF) * (100 + (1000000ULL << 32)))
+                  + (((word >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+
+            return static_cast<std::uint32_t>(word);
+        }
+
+        /// @brief The value of 2 digits, or `-1`.
+        inline int two_digits(const char* p) noexcept {
+            unsigned tens = static_cast<unsigned char>(p[0]) - '0';
+            unsigned ones = static_cast<unsigned char>(p[1]) - '0';
+
+            return (tens < 10 && ones < 10) ? static_cast<int>(tens * 10 + ones) : -1;
+        }
+
+        [[noreturn]] inline void invalid() {
+            throw std::invalid_argument("ash::parse_timestamp: The string is not an ISO 8601 timestamp.");
+        }
+    }
+}
+
+class ash::timestamp_formatter {
+public:
+
+// Operations
+
+    /// @brief Formats `ns` (nanoseconds since the epoch, UTC).
+    template <timestamp_precision P = timestamp_precision::nanoseconds>
+    auto format(std::int64_t ns) noexcept -> static_string<timestamp_size(P)>;
+
+private:
+    /// @brief Updates `text` to the second `second`.
+    void update(std::int64_t second) noexcept;
+
+    std::int64_t cached_day = std::numeric_limits<std::int64_t>::min();
+    std::int64_t cached_second = std::numeric_limits<std::int64_t>::min();
+
+    /// @brief "YYYY-MM-DDTHH:MM:SS" of `cached_second`.
+    char text[19] = {};
+};
+
+
+inline void ash::timestamp_formatter::update(std::int64_t second) noexcept {
+    std::int64_t day = second / 86400;
+    std::int64_t time = second % 86400;
+    if (time < 0) {
+        --day;
+        time += 86400;
+    }
+
+    if (day != cached_day) {
+        __timestamp_details::civil_date date = __timestamp_details::civil_from_days(day);
+
+        // `int64_t` nanoseconds are always in the years 1677...2262.
+        auto year = static_cast<unsigned>(date.year);
+        __timestamp_details::write2(text, year / 100);
+        __timestamp_details::write2(text + 2, year % 100);
+        text[4] = '-';
+        __timestamp_details::write2(text + 5, date.month);
+        text[7] = '-';
+        __timestamp_details::write2(text + 8, date.day);
+        text[10] = 'T';
+
+        cached_day = day;
+    }
+
+    auto seconds = static_cast<unsigned>(time);
+    __timestamp_details::write2(text + 11, seconds / 3600);
+    text[13] = ':';
+    __timestamp_details::write2(text + 14, seconds / 60 % 60);
+    text[16] = ':';
+    __timestamp_details::write2(text + 17, seconds % 60);
+
+    cached_second = second;
+}
+
+template <ash::timestamp_precision P>
+auto ash::timestamp_formatter::format(std::int64_t ns) noexcept -> static_string<timestamp_size(P)> {
+    std::int64_t second = ns / 1000000000;
+    std::int64_t fraction = ns % 1000000000;
+    if (fraction < 0) {
+        --second;
+        fraction += 1000000000;
+    }
+
+    if (second != cached_second)
+        update(second);
+
+    static_string<timestamp_size(P)> result;
+    result.resize_and_overwrite(timestamp_size(P), [this, fraction](char* out, std::size_t size) {
+        std::memcpy(out, text, 19);
+
+        constexpr std::size_t digits = static_cast<std::size_t>(P);
+        if (digits != 0) {
+            constexpr std::uint32_t divisor = digits == 3 ? 1000000 : (digits == 6 ? 1000 : 1);
+
+            out[19] = '.';
+            __timestamp_details::write_digits(out + 20, static_cast<std::uint32_t>(fraction) / divisor, digits);
+        }
+
+        out[size - 1] = 'Z';
+        return size;
+    });
+
+    return result;
+}
+
+template <ash::timestamp_precision P>
+auto ash::format_timestamp(std::int64_t ns) noexcept -> static_string<timestamp_size(P)> {
+    static thread_local timestamp_formatter formatter;
+
+    return formatter.format<P>(ns);
+}
+
+template <ash::timestamp_precision P, class Duration>
+auto ash::format_timestamp(std::chrono::time_point<std::chrono::system_clock, Duration> time) noexcept -> static_string<timestamp_size(P)> {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch());
+
+    return ash::format_timestamp<P>(static_cast<std::int64_t>(ns.count()));
+}
+
+inline std::int64_t ash::parse_timestamp(std::string_view str) {
+    using namespace __timestamp_details;
+
+    // "YYYY-MM-DDTHH:MM:SS" and at least 'Z' or "+HH:MM" after it.
+    if (str.size() < 20)
+        invalid();
+
+    const char* p = str.data();
+
+    // "YYYY-MM-" as a little-endian word: digits in bytes 0...3, 5 and 6.
+    std::uint64_t date = ash::simd::load8(p);
+    if (!digits_at(date, 0x00FFFF00FFFFFFFF) || p[4] != '-' || p[7] != '-')
+        invalid();
+
+    std::uint64_t date_pairs = digit_pairs_of(date, 0x00FFFF00FFFFFFFF);
+    std::int64_t year = (date_pairs & 0xFF) * 100 + ((date_pairs >> 16) & 0xFF);
+    unsigned month = (date_pairs >> 40) & 0xFF;
+
+    int day = two_digits(p + 8);
+
+    if (p[10] != 'T' && p[10] != 't' && p[10] != ' ')
+        invalid();
+
+    // "HH:MM:SS".
+    std::uint64_t clock = ash::simd::load8(p + 11);
+    if (!digits_at(clock, 0xFFFF00FFFF00FFFF) || p[13] != ':' || p[16] != ':')
+        invalid();
+
+    std::uint64_t values = digit_pairs_of(clock, 0xFFFF00FFFF00FFFF);
+    unsigned hour = values & 0xFF;
+    unsigned minute = (values >> 24) & 0xFF;
+    unsigned second = (values >> 48) & 0xFF;
+
+    if (month < 1 || month > 12 || day < 1 || static_cast<unsigned>(day) > days_in_month(year, month)
+        || hour > 23 || minute > 59 || second > 59)
+        invalid();
+
+    std::size_t i = 19;
+    std::int64_t fraction = 0;
+
+    if (str[i] == '.' || str[i] == ',') {
+        ++i;
+
+        std::size_t start = i;
+        std::uint32_t value = 0;
+
+        if (str.size() - i >= 8 && digits_at(ash::simd::load8(p + i), ~std::uint64_t(0))) {
+            value = eight_digits(ash::simd::load8(p + i));
+            i += 8;
+        }
+
+        while (i < str.size() && i - start < 9 && str[i] >= '0' && str[i] <= '9')
+            value = value * 10 + static_cast<std::uint32_t>(str[i++] - '0');
+
+        if (i == start)
+            invalid();
+
+        static constexpr std::uint32_t scale[] = { 1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1 };
+        fraction = static_cast<std::int64_t>(value) * scale[i - start];
+    }
+
+    // The offset from UTC, in seconds.
+    std::int64_t offset = 0;
+
+    if (i + 1 == str.size() && (str[i] == 'Z' || str[i] == 'z')) {
+        ++i;
+    }
+    else if (str.size() - i == 6 && (str[i] == '+' || str[i] == '-') && str[i + 3] == ':') {
+        int offset_hours = two_digits(p + i + 1);
+        int offset_minutes = two_digits(p + i + 4);
+
+        if (offset_hours < 0 || offset_hours > 23 || offset_minutes < 0 || offset_minutes > 59)
+            invalid();
+
+        offset = (offset_hours * 60 + offset_minutes) * 60;
+        if (str[i] == '-')
+            offset = -offset;
+
+        i += 6;
+    }
+    else {
+        invalid();
+    }
+
+    std::int64_t seconds = days_from_civil(year, month, static_cast<unsigned>(day)) * 86400
+                         + hour * 3600 + minute * 60 + second - offset;
+
+    std::int64_t ns = 0;
+    if (__builtin_mul_overflow(seconds, std::int64_t(1000000000), &ns) || __builtin_add_overflow(ns, fraction, &ns))
+        throw std::out_of_range("ash::parse_timestamp: The timestamp doesn't fit in 64 bits of nanoseconds.");
+
+    return ns;
+}
+
+#endif // ASH_TIMESTAMP
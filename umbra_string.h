@@ -0,0 +1,401 @@
+/*
+================================================================================
+  ash::basic_umbra_string - A 16-byte string handle with an inline prefix
+  (the "German string" layout of the Umbra database).
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    Layout (16 bytes, 16-byte aligned):
+
+      bytes 0..3   : size (`std::uint32_t`)
+      bytes 4..7   : the first 4 characters (null padded)
+      bytes 8..15  : short strings (size <= 12): characters 4..11 (null padded)
+                     long strings: pointer to the whole string
+
+    The first 8 bytes (size and prefix) are the "header". Most comparisons
+    between different strings finish on the header, without touching the
+    characters stored elsewhere. Short strings never touch any other memory.
+
+    A long `basic_umbra_string` doesn't own its characters. They usually live
+    in a `basic_static_string`, a `basic_static_string_table` or an
+    `ash::basic_umbra_arena`, which must outlive the handle.
+
+    Only 1-byte character types are supported.
+
+  Usage:
+    #include "ash/umbra_string.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_UMBRA_STRING
+
+================================================================================
+*/
+
+#ifndef ASH_UMBRA_STRING
+#define ASH_UMBRA_STRING
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "../ash/static_string.h"
+#include "../ash/hash.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @class basic_umbra_string
+    /// @brief A 16-byte non-owning string handle with a 4-character inline prefix. Strings up to
+    /// 12 characters are stored completely inline.
+    /// @tparam CharT Character-like type of each element. Must be 1 byte.
+    template <class CharT>
+    class basic_umbra_string;
+
+    /// @brief `ash::basic_umbra_string` of `char`s.
+    using umbra_string = basic_umbra_string<char>;
+
+    /// @class basic_umbra_arena
+    /// @brief Owns the characters of long `basic_umbra_string`s. Characters never move, so the
+    /// handles stay valid until the arena is destroyed.
+    /// @tparam CharT Character-like type of each element. Must be 1 byte.
+    template <class CharT>
+    class basic_umbra_arena;
+
+    /// @brief `ash::basic_umbra_arena` of `char`s.
+    using umbra_arena = basic_umbra_arena<char>;
+}
+
+template <class CharT>
+class alignas(16) ash::basic_umbra_string {
+    static_assert(sizeof(CharT) == 1, "`basic_umbra_string` only supports 1-byte character types.");
+
+public:
+
+// Nested types
+
+    using value_type = CharT;
+    using size_type = std::uint32_t;
+    using const_pointer = const CharT*;
+    using sv_type = std::basic_string_view<CharT>;
+
+    /// @brief Strings up to this size are stored inline.
+    static constexpr size_type inline_capacity = 12;
+
+    /// @brief Number of characters stored in the header.
+    static constexpr size_type prefix_size = 4;
+
+// Constructors
+
+    /// @brief Constructs an empty string.
+    basic_umbra_string() noexcept;
+
+    /// @brief Constructs a handle for [`str`, `str + count`).
+    /// @param str String pointer. If `count` is more than `inline_capacity`, it must outlive the handle.
+    /// @param count Number of characters.
+    /// @exception `std::out_of_range` if `count` doesn't fit into 32 bits.
+    basic_umbra_string(const CharT* str, std::size_t count);
+
+    /// @brief Constructs a handle for a view.
+    /// @param str The characters. If `str.size()` is more than `inline_capacity`, they must outlive the handle.
+    /// @exception `std::out_of_range` if `str.size()` doesn't fit into 32 bits.
+    explicit basic_umbra_string(sv_type str);
+
+    /// @brief Constructs a handle for a `basic_static_string`.
+    /// @param str The string. If `str.size()` is more than `inline_capacity`, it must outlive the handle.
+    template <std::size_t N>
+    explicit basic_umbra_string(const basic_static_string<CharT, N>& str);
+
+// Element access
+
+    /// @brief Pointer to the characters. For short strings, this points into the handle itself.
+    const_pointer data() const noexcept;
+
+    /// @brief The header (size and prefix) as one integer. Two strings with different headers
+    /// are never equal.
+    std::uint64_t header() const noexcept;
+
+// Capacity
+
+    /// @brief Checks whether the string is empty.
+    bool empty() const noexcept;
+
+    /// @brief Number of characters.
+    size_type size() const noexcept;
+
+    /// @brief Checks whether the characters are stored inside the handle.
+    bool is_inline() const noexcept;
+
+// Operations
+
+    /// @brief Lexicographically compares the two strings, just like `std::basic_string_view::compare`.
+    /// @return Negative value if `*this` comes before `other`, zero if they are equal and positive
+    /// value if `*this` comes after `other`.
+    int compare(const basic_umbra_string& other) const noexcept;
+
+    /// @brief Hashes the characters. The result is the same as `std::hash` of an equal
+    /// `basic_static_string`.
+    std::size_t hash() const noexcept;
+
+// Conversions
+
+    /// @brief A view over [`data()`, `data() + size()`). For short strings it points into the handle.
+    operator sv_type() const noexcept;
+
+    friend bool operator==(const basic_umbra_string& lhs, const basic_umbra_string& rhs) noexcept {
+        // Size and prefix at once.
+        if (lhs.word(0) != rhs.word(0))
+            return false;
+
+        // Short strings are null padded, so the second word decides.
+        if (lhs.is_inline())
+            return lhs.word(1) == rhs.word(1);
+
+        return lhs.pointer() == rhs.pointer()
+            || std::memcmp(lhs.pointer() + prefix_size, rhs.pointer() + prefix_size, lhs.size() - prefix_size) == 0;
+    }
+
+    friend bool operator!=(const basic_umbra_string& lhs, const basic_umbra_string& rhs) noexcept { return !(lhs == rhs); }
+    friend bool operator<(const basic_umbra_string& lhs, const basic_umbra_string& rhs) noexcept { return lhs.compare(rhs) < 0; }
+    friend bool operator<=(const basic_umbra_string& lhs, const basic_umbra_string& rhs) noexcept { return lhs.compare(rhs) <= 0; }
+    friend bool operator>(const basic_umbra_string& lhs, const basic_umbra_string& rhs) noexcept { return lhs.compare(rhs) > 0; }
+    friend bool operator>=(const basic_umbra_string& lhs, const basic_umbra_string& rhs) noexcept { return lhs.compare(rhs) >= 0; }
+
+private:
+    std::uint64_t word(std::size_t i) const noexcept;
+    const CharT* pointer() const noexcept;
+
+    /// @brief Raw bytes, see the layout at the top of the file. Everything is accessed through
+    /// `memcpy`, so the same bytes can hold both characters and a pointer.
+    unsigned char raw[16];
+};
+
+template <class CharT>
+class ash::basic_umbra_arena {
+    static_assert(sizeof(CharT) == 1, "`basic_umbra_arena` only supports 1-byte character types.");
+
+public:
+    using sv_type = std::basic_string_view<CharT>;
+
+    /// @brief Constructs an empty arena.
+    /// @param block_size Size of the blocks the characters are allocated from.
+    explicit basic_umbra_arena(std::size_t block_size = 64 * 1024);
+
+    basic_umbra_arena(const basic_umbra_arena&) = delete;
+    basic_umbra_arena& operator=(const basic_umbra_arena&) = delete;
+    basic_umbra_arena(basic_umbra_arena&& other) noexcept;
+    basic_umbra_arena& operator=(basic_umbra_arena&& other) noexcept;
+
+    /// @brief Makes a handle for `str`. Long strings are copied into the arena first.
+    basic_umbra_string<CharT> store(sv_type str);
+
+    /// @brief Makes a handle for `str`. Long strings are copied into the arena first.
+    template <std::size_t N>
+    basic_umbra_string<CharT> store(const basic_static_string<CharT, N>& str);
+
+    /// @brief Number of bytes allocated by the arena.
+    std::size_t allocated() const noexcept;
+
+private:
+    std::vector<std::unique_ptr<CharT[]>> blocks;
+    std::size_t block_size;
+
+    /// @brief The block which is being filled, and how much of it is used.
+    CharT* current = nullptr;
+    std::size_t used = 0;
+    std::size_t total = 0;
+};
+
+
+template <class CharT>
+ash::basic_umbra_string<CharT>::basic_umbra_string() noexcept : raw {} {}
+
+template <class CharT>
+ash::basic_umbra_string<CharT>::basic_umbra_string(const CharT* str, std::size_t count) : raw {} {
+    ash::throw_if_outside_of_capacity<std::size_t>(UINT32_MAX, count);
+
+    size_type len = static_cast<size_type>(count);
+    std::memcpy(raw, &len, 4);
+
+    if (len <= inline_capacity) {
+        std::memcpy(raw + 4, str, len);
+        return;
+    }
+
+    std::memcpy(raw + 4, str, prefix_size);
+    std::memcpy(raw + 8, &str, sizeof(str));
+}
+
+template <class CharT>
+ash::basic_umbra_string<CharT>::basic_umbra_string(sv_type str) : basic_umbra_string(str.data(), str.size()) {}
+
+template <class CharT>
+template <std::size_t N>
+ash::basic_umbra_string<CharT>::basic_umbra_string(const basic_static_string<CharT, N>& str) : basic_umbra_string(str.data(), str.size()) {}
+
+template <class CharT>
+typename ash::basic_umbra_string<CharT>::const_pointer ash::basic_umbra_string<CharT>::data() const noexcept {
+    return is_inline() ? reinterpret_cast<const CharT*>(raw + 4) : pointer();
+}
+
+template <class CharT>
+std::uint64_t ash::basic_umbra_string<CharT>::header() const noexcept {
+    return word(0);
+}
+
+template <class CharT>
+bool ash::basic_umbra_string<CharT>::empty() const noexcept {
+    return size() == 0;
+}
+
+template <class CharT>
+typename ash::basic_umbra_string<CharT>::size_type ash::basic_umbra_string<CharT>::size() const noexcept {
+    size_type len;
+    std::memcpy(&len, raw, 4);
+    return len;
+}
+
+template <class CharT>
+bool ash::basic_umbra_string<CharT>::is_inline() const noexcept {
+    return size() <= inline_capacity;
+}
+
+template <class CharT>
+int ash::basic_umbra_string<CharT>::compare(const basic_umbra_string& other) const noexcept {
+    // The prefixes are compared as big-endian integers, which is the same as comparing
+    // them character by character (as `unsigned char`s).
+    std::uint32_t a, b;
+    std::memcpy(&a, raw + 4, 4);
+    std::memcpy(&b, other.raw + 4, 4);
+
+    if (a != b) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        a = __builtin_bswap32(a);
+        b = __builtin_bswap32(b);
+#endif
+        return (a < b) ? -1 : 1;
+    }
+
+    size_type len = size(), other_len = other.size();
+    size_type common = (len < other_len) ? len : other_len;
+
+    if (common > prefix_size) {
+        int result = std::memcmp(data() + prefix_size, other.data() + prefix_size, common - prefix_size);
+        if (result != 0)
+            return result;
+    }
+
+    if (len == other_len)
+        return 0;
+
+    return (len < other_len) ? -1 : 1;
+}
+
+template <class CharT>
+std::size_t ash::basic_umbra_string<CharT>::hash() const noexcept {
+    return ash::hash_bytes(data(), size());
+}
+
+template <class CharT>
+ash::basic_umbra_string<CharT>::operator sv_type() const noexcept {
+    return sv_type(data(), size());
+}
+
+template <class CharT>
+std::uint64_t ash::basic_umbra_string<CharT>::word(std::size_t i) const noexcept {
+    std::uint64_t w;
+    std::memcpy(&w, raw + 8 * i, 8);
+    return w;
+}
+
+template <class CharT>
+const CharT* ash::basic_umbra_string<CharT>::pointer() const noexcept {
+    const CharT* p;
+    std::memcpy(&p, raw + 8, sizeof(p));
+    return p;
+}
+
+template <class CharT>
+ash::basic_umbra_arena<CharT>::basic_umbra_arena(std::size_t block_size) : block_size(block_size) {}
+
+template <class CharT>
+ash::basic_umbra_arena<CharT>::basic_umbra_arena(basic_umbra_arena&& other) noexcept
+    : blocks(std::move(other.blocks)), block_size(other.block_size), current(other.current), used(other.used), total(other.total) {
+    other.current = nullptr;
+    other.used = 0;
+    other.total = 0;
+}
+
+template <class CharT>
+ash::basic_umbra_arena<CharT>& ash::basic_umbra_arena<CharT>::operator=(basic_umbra_arena&& other) noexcept {
+    blocks = std::move(other.blocks);
+    block_size = other.block_size;
+    current = other.current;
+    used = other.used;
+    total = other.total;
+
+    other.current = nullptr;
+    other.used = 0;
+    other.total = 0;
+    return *this;
+}
+
+template <class CharT>
+ash::basic_umbra_string<CharT> ash::basic_umbra_arena<CharT>::store(sv_type str) {
+    if (str.size() <= basic_umbra_string<CharT>::inline_capacity)
+        return basic_umbra_string<CharT>(str);
+
+    // Huge strings get their own block, so they don't waste the rest of the current one.
+    if (str.size() > block_size) {
+        blocks.emplace_back(new CharT[str.size()]);
+        total += str.size();
+
+        std::memcpy(blocks.back().get(), str.data(), str.size());
+        return basic_umbra_string<CharT>(blocks.back().get(), str.size());
+    }
+
+    if (current == nullptr || str.size() > block_size - used) {
+        blocks.emplace_back(new CharT[block_size]);
+        total += block_size;
+
+        current = blocks.back().get();
+        used = 0;
+    }
+
+    CharT* dest = current + used;
+    std::memcpy(dest, str.data(), str.size());
+    used += str.size();
+
+    return basic_umbra_string<CharT>(dest, str.size());
+}
+
+template <class CharT>
+template <std::size_t N>
+ash::basic_umbra_string<CharT> ash::basic_umbra_arena<CharT>::store(const basic_static_string<CharT, N>& str) {
+    return store(sv_type(str.data(), str.size()));
+}
+
+template <class CharT>
+std::size_t ash::basic_umbra_arena<CharT>::allocated() const noexcept {
+    return total;
+}
+
+// Hash support
+
+namespace std {
+    /// @brief Hash support for `ash::basic_umbra_string`. Equal to the hash of an equal
+    /// `ash::basic_static_string`.
+    template <class CharT>
+    struct hash<ash::basic_umbra_string<CharT>> {
+        std::size_t operator()(const ash::basic_umbra_string<CharT>& str) const noexcept {
+            return str.hash();
+        }
+    };
+} // Hash support
+
+#endif // ASH_UMBRA_STRING
@@ -0,0 +1,660 @@
+/*
+================================================================================
+  ash/utf.h - Validation and transcoding between UTF-8, UTF-16 and UTF-32.
+
+  License: MIT
+  Author: S. Navid Ashrafi
+  GitHub: snaCW
+
+  Description:
+    Converts between `static_string` / `static_u8string`, `static_u16string`,
+    `static_u32string` and `static_wstring`. The encoding follows the size of
+    the character type: 1 byte is UTF-8, 2 bytes UTF-16, 4 bytes UTF-32 (so
+    `wchar_t` is UTF-16 on Windows and UTF-32 elsewhere).
+
+    - `ash::is_valid_utf(str)` validates.
+    - `ash::count_code_points(str)` counts the code points of a valid string.
+    - `ash::transcode<To>(str)` converts, with the capacity of the result
+      computed from the worst-case expansion (`transcoded_capacity`), e.g.
+      `transcode<char>(static_u16string<10>)` is a `static_string<30>`.
+      Invalid input (including surrogates and overlong forms) throws
+      `std::invalid_argument`.
+
+    All functions are constexpr. At runtime they use SIMD kernels:
+
+    - UTF-8 validation uses the lookup algorithm of Keiser and Lemire with
+      SSSE3 (three `pshufb` table lookups per 16 bytes). With only SSE2, runs
+      of ASCII are skipped 16 bytes at a time.
+    - The transcoders convert runs of ASCII 16 (or 8) characters at a time,
+      with one widening or narrowing shuffle. Everything else goes through
+      the scalar codec, which is also the constexpr fallback.
+
+  Usage:
+    #include "ash/utf.h"
+
+  Macros:
+    Upon including this file in your project, the following macro(s) will be
+    globally exposed:
+      - ASH_UTF
+
+================================================================================
+*/
+
+#ifndef ASH_UTF
+#define ASH_UTF
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include "../ash/simd.h"
+#include "../ash/static_string.h"
+#include "../ash/throw_if.h"
+
+namespace ash {
+    /// @brief Returned by the low-level `transcode` for invalid input.
+    constexpr std::size_t utf_error = std::size_t(-1);
+
+    /// @brief The maximum number of `To` characters which `n` characters of `From` transcode to.
+    template <class From, class To>
+    constexpr std::size_t transcoded_capacity(std::size_t n) noexcept;
+
+    /// @brief Checks if `str` is valid UTF-8, UTF-16 or UTF-32 (after the size of `CharT`).
+    template <class CharT>
+    constexpr bool is_valid_utf(std::basic_string_view<CharT> str) noexcept;
+
+    template <class CharT, std::size_t N>
+    constexpr bool is_valid_utf(const basic_static_string<CharT, N>& str) noexcept;
+
+    /// @brief The number of code points in `str`.
+    /// @note `str` must be valid, otherwise the result is meaningless.
+    template <class CharT>
+    constexpr std::size_t count_code_points(std::basic_string_view<CharT> str) noexcept;
+
+    template <class CharT, std::size_t N>
+    constexpr std::size_t count_code_points(const basic_static_string<CharT, N>& str) noexcept;
+
+    /// @brief Transcodes [`in`, `in + size`) into `out`.
+    /// @param out Must have room for `transcoded_capacity<From, To>(size)` characters.
+    /// @return The number of characters written, or `utf_error` if the input is invalid.
+    template <class To, class From>
+    constexpr std::size_t transcode(const From* in, std::size_t size, To* out) noexcept;
+
+    /// @brief Transcodes `str` into a string which is large enough for any input of its capacity.
+    /// @exception `std::invalid_argument` if `str` is invalid.
+    template <class To, class From, std::size_t N>
+    constexpr auto transcode(const basic_static_string<From, N>& str) -> basic_static_string<To, transcoded_capacity<From, To>(N)>;
+
+    /// @brief Transcodes `str` into a string of capacity `N`.
+    /// @exception `std::invalid_argument` if `str` is invalid.
+    /// @exception `std::out_of_range` if the result is longer than `N`.
+    template <class To, std::size_t N, class From>
+    constexpr basic_static_string<To, N> transcode(std::basic_string_view<From> str);
+
+    namespace __utf_details {
+        /// @brief Returned by the decoders for invalid input.
+        constexpr char32_t invalid = 0xFFFFFFFF;
+
+        template <class CharT>
+        constexpr std::size_t width() noexcept {
+            static_assert(sizeof(CharT) == 1 || sizeof(CharT) == 2 || sizeof(CharT) == 4,
+                          "ash::utf: The character type must have 1, 2 or 4 bytes.");
+            return sizeof(CharT);
+        }
+
+        /// @brief Decodes the code point at `in[i]` and moves `i` past it.
+        template <class CharT>
+        constexpr char32_t decode(const CharT* in, std::size_t size, std::size_t& i) noexcept;
+
+        /// @brief Encodes `cp` at `out` and returns the number of characters written.
+        template <class CharT>
+        constexpr std::size_t encode(char32_t cp, CharT* out) noexcept;
+
+        /// @brief The scalar transcoder, from `in[i]` until `in[end]` (which may be exceeded by
+        /// the last code point). Returns the new end of `out`, or `nullptr` for invalid input.
+        template <class To, class From>
+        constexpr To* transcode_scalar(const From* in, std::size_t size, std::size_t& i, std::size_t end, To* out) noexcept;
+
+        template <class CharT>
+        constexpr bool validate_scalar(const CharT* in, std::size_t size) noexcept;
+
+        /// @brief Validates UTF-8 with SIMD.
+        bool validate_utf8(const unsigned char* in, std::size_t size) noexcept;
+
+        /// @brief The number of bytes of UTF-8 which aren't continuation bytes.
+        std::size_t count_utf8(const unsigned char* in, std::size_t size) noexcept;
+
+        /// @brief Transcodes with the SIMD fast paths for ASCII.
+        template <class To, class From>
+        std::size_t transcode_simd(const From* in, std::size_t size, To* out) noexcept;
+    }
+}
+
+template <class From, class To>
+constexpr std::size_t ash::transcoded_capacity(std::size_t n) noexcept {
+    constexpr std::size_t from = __utf_details::width<From>();
+    constexpr std::size_t to = __utf_details::width<To>();
+
+    // A code point is at most 4 bytes of UTF-8 and 2 units of UTF-16. The worst cases per input
+    // character are: a 3-byte code point from one UTF-16 unit, a 4-byte one from one UTF-32 unit,
+    // and a surrogate pair from one UTF-32 unit.
+    if constexpr (to == 1)
+        return n * (from == 1 ? 1 : (from == 2 ? 3 : 4));
+    if constexpr (to == 2)
+        return n * (from == 4 ? 2 : 1);
+
+    return n;
+}
+
+template <class CharT>
+constexpr char32_t ash::__utf_details::decode(const CharT* in, std::size_t size, std::size_t& i) noexcept {
+    constexpr std::size_t w = width<CharT>();
+
+    if constexpr (w == 4) {
+        char32_t cp = static_cast<char32_t>(in[i++]);
+        return (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) ? invalid : cp;
+    }
+
+    if constexpr (w == 2) {
+        char32_t unit = static_cast<char16_t>(in[i++]);
+        if (unit < 0xD800 || unit > 0xDFFF)
+            return unit;
+
+        if (unit > 0xDBFF || i == size)
+            return invalid;
+
+        char32_t low = static_cast<char16_t>(in[i]);
+        if (low < 0xDC00 || low > 0xDFFF)
+            return invalid;
+
+        ++i;
+        return 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    char32_t lead = static_cast<unsigned char>(in[i++]);
+    if (lead < 0x80)
+        return lead;
+
+    std::size_t extra = 0;
+    char32_t min = 0;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        extra = 1;
+        min = 0x80;
+        lead &= 0x1F;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF) {
+        extra = 2;
+        min = 0x800;
+        lead &= 0x0F;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4) {
+        extra = 3;
+        min = 0x10000;
+        lead &= 0x07;
+    }
+    else {
+        return invalid;
+    }
+
+    if (size - i < extra)
+        return invalid;
+
+    char32_t cp = lead;
+    for (std::size_t k = 0; k < extra; ++k) {
+        unsigned char c = static_cast<unsigned char>(in[i + k]);
+        if ((c & 0xC0) != 0x80)
+            return invalid;
+
+        cp = (cp << 6) | (c & 0x3F);
+    }
+
+    // Overlong forms, surrogates, and beyond U+10FFFF.
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+        return invalid;
+
+    i += extra;
+    return cp;
+}
+
+template <class CharT>
+constexpr std::size_t ash::__utf_details::encode(char32_t cp, CharT* out) noexcept {
+    constexpr std::size_t w = width<CharT>();
+
+    if constexpr (w == 4) {
+        out[0] = static_cast<CharT>(cp);
+        return 1;
+    }
+
+    if constexpr (w == 2) {
+        if (cp < 0x10000) {
+            out[0] = static_cast<CharT>(cp);
+            return 1;
+        }
+
+        cp -= 0x10000;
+        out[0] = static_cast<CharT>(0xD800 + (cp >> 10));
+        out[1] = static_cast<CharT>(0xDC00 + (cp & 0x3FF));
+        return 2;
+    }
+
+    if (cp < 0x80) {
+        out[0] = static_cast<CharT>(cp);
+        return 1;
+    }
+
+    if (cp < 0x800) {
+        out[0] = static_cast<CharT>(0xC0 | (cp >> 6));
+        out[1] = static_cast<CharT>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+
+    if (cp < 0x10000) {
+        out[0] = static_cast<CharT>(0xE0 | (cp >> 12));
+        out[1] = static_cast<CharT>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<CharT>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+
+    out[0] = static_cast<CharT>(0xF0 | (cp >> 18));
+    out[1] = static_cast<CharT>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<CharT>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<CharT>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+template <class To, class From>
+constexpr To* ash::__utf_details::transcode_scalar(const From* in, std::size_t size, std::size_t& i, std::size_t end, To* out) noexcept {
+    while (i < end) {
+        char32_t cp = decode(in, size, i);
+        if (cp == invalid)
+            return nullptr;
+
+        out += encode(cp, out);
+    }
+
+    return out;
+}
+
+template <class CharT>
+constexpr bool ash::__utf_details::validate_scalar(const CharT* in, std::size_t size) noexcept {
+    std::size_t i = 0;
+    while (i < size)
+        if (decode(in, size, i) == invalid)
+            return false;
+
+    return true;
+}
+
+#ifdef ASH_SIMD_SSE2
+
+namespace ash {
+    namespace __utf_details {
+        /// @brief `true` if the 16 bytes at `p` are ASCII.
+        inline bool ascii16(const void* p) noexcept {
+            return _mm_movemask_epi8(_mm_loadu_si128(static_cast<const __m128i*>(p))) == 0;
+        }
+
+#ifdef ASH_SIMD_SSSE3
+        // The error classes of Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction
+        // Per Byte". Every pair of adjacent bytes is classified by three table lookups (the high
+        // and the low nibble of the first byte, the high nibble of the second one); an error is a
+        // class that all three agree on.
+        constexpr std::uint8_t too_short = 1 << 0;
+        constexpr std::uint8_t too_long = 1 << 1;
+        constexpr std::uint8_t overlong_3 = 1 << 2;
+        constexpr std::uint8_t too_large = 1 << 3;
+        constexpr std::uint8_t surrogate = 1 << 4;
+        constexpr std::uint8_t overlong_2 = 1 << 5;
+        constexpr std::uint8_t too_large_1000 = 1 << 6;
+        constexpr std::uint8_t overlong_4 = 1 << 6;
+        constexpr std::uint8_t two_conts = 1 << 7;
+        constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+        inline __m128i table(const std::uint8_t (&t)[16]) noexcept {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(t));
+        }
+
+        inline __m128i high_nibbles(__m128i v) noexcept {
+            return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+        }
+
+        /// @brief The errors of the 16 bytes of `input`, where `previous` is the block before it.
+        inline __m128i utf8_errors(__m128i input, __m128i previous) noexcept {
+            static constexpr std::uint8_t byte_1_high[16] = {
+                // 0_______ ________: ASCII followed by anything but a continuation.
+                too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+                // 10______ ________
+                two_conts, two_conts, two_conts, two_conts,
+                // 1100____, 1101____, 1110____, 1111____
+                too_short | overlong_2,
+                too_short,
+                too_short | overlong_3 | surrogate,
+                too_short | too_large | too_large_1000 | overlong_4
+            };
+
+            static constexpr std::uint8_t byte_1_low[16] = {
+                carry | overlong_3 | overlong_2 | overlong_4,
+                carry | overlong_2,
+                carry,
+                carry,
+                carry | too_large,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000 | surrogate,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000
+            };
+
+            static constexpr std::uint8_t byte_2_high[16] = {
+                // ________ 0_______
+                too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+                // ________ 1000____, 1001____, 101_____
+                too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+                too_long | overlong_2 | two_conts | overlong_3 | too_large,
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                // ________ 11______
+                too_short, too_short, too_short, too_short
+            };
+
+            __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+
+            __m128i special = _mm_and_si128(
+                _mm_and_si128(_mm_shuffle_epi8(table(byte_1_high), high_nibbles(prev1)),
+                              _mm_shuffle_epi8(table(byte_1_low), _mm_and_si128(prev1, _mm_set1_epi8(0x0F)))),
+                _mm_shuffle_epi8(table(byte_2_high), high_nibbles(input)));
+
+            // The second continuation of 3- and 4-byte sequences, and the third one of 4-byte
+            // sequences, must be there. Only `111_____` two bytes back or `1111____` three bytes
+            // back stay at or above 0x80 after the saturating subtraction.
+            __m128i prev2 = _mm_alignr_epi8(input, previous, 14);
+            __m128i prev3 = _mm_alignr_epi8(input, previous, 13);
+            __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+
+            return _mm_xor_si128(must_be_continuation, special);
+        }
+
+        /// @brief Non-zero if the block ends in the middle of a multi-byte sequence.
+        inline __m128i utf8_incomplete(__m128i input) noexcept {
+            const __m128i max = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                              static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+            return _mm_subs_epu8(input, max);
+        }
+#endif // ASH_SIMD_SSSE3
+    }
+}
+
+inline bool ash::__utf_details::validate_utf8(const unsigned char* in, std::size_t size) noexcept {
+#ifdef ASH_SIMD_SSSE3
+    __m128i error = _mm_setzero_si128();
+    __m128i previous = _mm_setzero_si128();
+    __m128i incomplete = _mm_setzero_si128();
+
+    auto block = [&](__m128i input) {
+        if (_mm_movemask_epi8(input) == 0) {
+            // ASCII, which is only an error if the previous block was waiting for continuations.
+            error = _mm_or_si128(error, incomplete);
+            incomplete = _mm_setzero_si128();
+        }
+        else {
+            error = _mm_or_si128(error, utf8_errors(input, previous));
+            incomplete = utf8_incomplete(input);
+        }
+
+        previous = input;
+    };
+
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+        block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+
+    if (i < size) {
+        // Zero padding is ASCII, so a sequence cut by the end of the input is still an error.
+        alignas(16) unsigned char tail[16] = {};
+        std::memcpy(tail, in + i, size - i);
+        block(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+    }
+
+    error = _mm_or_si128(error, incomplete);
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+#else
+    std::size_t i = 0;
+    while (i < size) {
+        if (size - i >= 16 && ascii16(in + i)) {
+            i += 16;
+            continue;
+        }
+
+        // Always stops at the start of a code point.
+        std::size_t end = (size - i >= 16) ? i + 16 : size;
+        while (i < end)
+            if (decode(in, size, i) == invalid)
+                return false;
+    }
+
+    return true;
+#endif
+}
+
+inline std::size_t ash::__utf_details::count_utf8(const unsigned char* in, std::size_t size) noexcept {
+    std::size_t count = 0;
+    std::size_t i = 0;
+
+    // Continuation bytes are -128...-65 as signed chars.
+    const __m128i last_continuation = _mm_set1_epi8(-65);
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        count += ash::simd::popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, last_continuation))));
+    }
+
+    for (; i < size; ++i)
+        count += (in[i] & 0xC0) != 0x80;
+
+    return count;
+}
+
+template <class To, class From>
+std::size_t ash::__utf_details::transcode_simd(const From* in, std::size_t size, To* out) noexcept {
+    constexpr std::size_t from = width<From>();
+    constexpr std::size_t to = width<To>();
+
+    // The number of input characters per vector.
+    constexpr std::size_t step = 16 / from;
+
+    To* first = out;
+    std::size_t i = 0;
+
+    while (i < size) {
+        if (size - i >= step) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            bool ascii;
+
+            if constexpr (from == 1)
+                ascii = _mm_movemask_epi8(v) == 0;
+            else if constexpr (from == 2)
+                ascii = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80))), _mm_setzero_si128())) == 0xFFFF;
+            else
+                ascii = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFFFFF80))), _mm_setzero_si128())) == 0xFFFF;
+
+            if (ascii) {
+                // Widens or narrows the characters, which are all below 0x80.
+                if constexpr (from == to) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+                }
+                else if constexpr (from == 1) {
+                    __m128i zero = _mm_setzero_si128();
+                    __m128i lo = _mm_unpacklo_epi8(v, zero);
+                    __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+                    if constexpr (to == 2) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), hi);
+                    }
+                    else {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo, zero));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi, zero));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi, zero));
+                    }
+                }
+                else if constexpr (from == 2) {
+                    if constexpr (to == 1) {
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v, v));
+                    }
+                    else {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(v, _mm_setzero_si128()));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(v, _mm_setzero_si128()));
+                    }
+                }
+                else {
+                    __m128i narrow = _mm_packs_epi32(v, v);
+
+                    if constexpr (to == 1) {
+                        int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(narrow, narrow));
+                        std::memcpy(out, &bytes, 4);
+                    }
+                    else {
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), narrow);
+                    }
+                }
+
+                i += step;
+                out += step;
+                continue;
+            }
+        }
+
+        // The rest of the block, one code point at a time. It always stops at the start of a
+        // code point.
+        std::size_t end = (size - i >= step) ? i + step : size;
+        out = transcode_scalar(in, size, i, end, out);
+
+        if (out == nullptr)
+            return utf_error;
+    }
+
+    return static_cast<std::size_t>(out - first);
+}
+
+#endif // ASH_SIMD_SSE2
+
+template <class CharT>
+constexpr bool ash::is_valid_utf(std::basic_string_view<CharT> str) noexcept {
+#ifdef ASH_SIMD_SSE2
+    if constexpr (__utf_details::width<CharT>() == 1)
+        if (!__builtin_is_constant_evaluated())
+            return __utf_details::validate_utf8(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+#endif
+
+    return __utf_details::validate_scalar(str.data(), str.size());
+}
+
+template <class CharT, std::size_t N>
+constexpr bool ash::is_valid_utf(const basic_static_string<CharT, N>& str) noexcept {
+    return ash::is_valid_utf(std::basic_string_view<CharT>(str.data(), str.size()));
+}
+
+template <class CharT>
+constexpr std::size_t ash::count_code_points(std::basic_string_view<CharT> str) noexcept {
+    constexpr std::size_t w = __utf_details::width<CharT>();
+
+    if constexpr (w == 4)
+        return str.size();
+
+#ifdef ASH_SIMD_SSE2
+    if constexpr (w == 1)
+        if (!__builtin_is_constant_evaluated())
+            return __utf_details::count_utf8(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+#endif
+
+    // Everything but UTF-8 continuation bytes, or UTF-16 low surrogates.
+    std::size_t count = 0;
+    for (CharT c : str) {
+        if constexpr (w == 1)
+            count += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+        else
+            count += (static_cast<char16_t>(c) & 0xFC00) != 0xDC00;
+    }
+
+    return count;
+}
+
+template <class CharT, std::size_t N>
+constexpr std::size_t ash::count_code_points(const basic_static_string<CharT, N>& str) noexcept {
+    return ash::count_code_points(std::basic_string_view<CharT>(str.data(), str.size()));
+}
+
+template <class To, class From>
+constexpr std::size_t ash::transcode(const From* in, std::size_t size, To* out) noexcept {
+#ifdef ASH_SIMD_SSE2
+    if (!__builtin_is_constant_evaluated())
+        return __utf_details::transcode_simd(in, size, out);
+#endif
+
+    std::size_t i = 0;
+    To* end = __utf_details::transcode_scalar(in, size, i, size, out);
+
+    return end ? static_cast<std::size_t>(end - out) : utf_error;
+}
+
+template <class To, class From, std::size_t N>
+constexpr auto ash::transcode(const basic_static_string<From, N>& str) -> basic_static_string<To, transcoded_capacity<From, To>(N)> {
+    basic_static_string<To, transcoded_capacity<From, To>(N)> result;
+
+    std::size_t written = 0;
+    result.resize_and_overwrite(result.capacity(), [&str, &written](To* out, std::size_t) {
+        written = ash::transcode(str.data(), str.size(), out);
+        return written == utf_error ? 0 : written;
+    });
+
+    if (written == utf_error)
+        throw std::invalid_argument("ash::transcode: The input is not valid UTF.");
+
+    return result;
+}
+
+template <class To, std::size_t N, class From>
+constexpr ash::basic_static_string<To, N> ash::transcode(std::basic_string_view<From> str) {
+    // A sure fit is transcoded in place. Otherwise the size is found first.
+    std::size_t size = 0;
+
+    if (transcoded_capacity<From, To>(str.size()) > N) {
+        if (!ash::is_valid_utf(str))
+            throw std::invalid_argument("ash::transcode: The input is not valid UTF.");
+
+        std::size_t i = 0;
+        To units[4] {};
+        while (i < str.size())
+            size += __utf_details::encode(__utf_details::decode(str.data(), str.size(), i), units);
+
+        ash::throw_if_outside_of_capacity(N, size);
+    }
+
+    basic_static_string<To, N> result;
+
+    std::size_t written = 0;
+    result.resize_and_overwrite(N, [&str, &written](To* out, std::size_t) {
+        written = ash::transcode(str.data(), str.size(), out);
+        return written == utf_error ? 0 : written;
+    });
+
+    if (written == utf_error)
+        throw std::invalid_argument("ash::transcode: The input is not valid UTF.");
+
+    return result;
+}
+
+#endif // ASH_UTF